@@ -0,0 +1,185 @@
+#include <basic_coroutine.hpp>
+#include <run_queue.hpp>
+#include <waker.hpp>
+
+#include "../measure.hpp"
+#include "../overhead/minimal.hpp"
+
+#include <coroutine>
+#include <cstdio>
+#include <string>
+
+using namespace tmf;
+
+// counts the locals created in frames and destroyed by frames being reclaimed
+std::size_t created_locals{ 0 };
+std::size_t destroyed_locals{ 0 };
+
+struct local
+{
+  std::string payload{ "owned by the suspended frame, large enough to live on the heap" };
+  local() { ++created_locals; }
+  ~local() { ++destroyed_locals; }
+};
+
+// live frames on this thread
+std::size_t live_frames()
+{
+  auto stats = frame_allocations();
+  return stats.allocations - stats.deallocations;
+}
+
+// memory stays flat when every frame was given back and every local it held destroyed, reports whether it did
+bool flat()
+{
+  bool const reclaimed = live_frames() == 0 && destroyed_locals == created_locals;
+  std::printf("  live frames %zu, locals created %zu, destroyed %zu%s\n",
+    live_frames(), created_locals, destroyed_locals, reclaimed ? "" : ", LEAKED");
+  created_locals = 0;
+  destroyed_locals = 0;
+  return reclaimed;
+}
+
+// an infinite sequence, only ever dropped while suspended at a yield
+struct Sequence : basic_coroutine<Sequence>
+{
+  static constexpr bool single_threaded = true;
+  long last{ 0 };
+  auto on_invoke() { return co_control::suspend; }
+  void on_return() {}
+  co_control on_yield(long value)
+  {
+    last = value;
+    return co_control::suspend;
+  }
+};
+
+Sequence fibonacci()
+{
+  local held;
+  long a = 0, b = 1;
+  while (true)
+  {
+    co_yield a;
+    b = std::exchange(a, b) + b;
+  }
+}
+
+minimal::generator<long> minimal_fibonacci()
+{
+  local held;
+  long a = 0, b = 1;
+  while (true)
+  {
+    co_yield a;
+    b = std::exchange(a, b) + b;
+  }
+}
+
+// something that holds on to whoever awaits it, the way synchronization objects do
+struct parked
+{
+  waker waiter{};
+
+  struct awaiter
+  {
+    parked* self;
+    bool await_ready() { return false; }
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) { self->waiter = waker::of(handle); }
+    void await_resume() {}
+  };
+
+  awaiter operator co_await() { return awaiter{ this }; }
+};
+
+struct Awaiting : basic_coroutine<Awaiting>
+{
+  auto on_invoke() { return co_control::resume; }
+  void on_return() {}
+};
+
+Awaiting await_parked(parked& p)
+{
+  local held;
+  co_await p;
+  co_await p; // never reached once abandoned, the waker destroys the frame instead of resuming it
+}
+
+// resumed by a run loop, dropped while its resume is still queued
+struct Scheduled : basic_coroutine<Scheduled>
+{
+  static inline run_queue* loop{ nullptr };
+  void executor(schedule_node& node) { loop->execute(node); }
+  auto on_invoke() { return co_control::resume; }
+  void on_return() {}
+  co_control on_yield() { return co_control::suspend; }
+};
+
+Scheduled scheduled()
+{
+  local held;
+  while (true)
+  {
+    co_yield nothing;
+  }
+}
+
+int main()
+{
+  constexpr std::size_t n = 1'000'000;
+
+  bench::header("hand-written");
+
+  // a hand-written owner destroys whatever it holds, that is the floor
+  auto minimal_drop = bench::measure(n, [](std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto c = minimal_fibonacci();
+      c.resume();
+      c.resume();
+    }
+  });
+  created_locals = 0;
+  destroyed_locals = 0;
+  bool reclaimed = true;
+  bench::report("drop at co_yield, destroyed at once", bench::measure(n, [](std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto c = fibonacci();
+      (void)c.resume();
+      (void)c.resume();
+    }
+  }), minimal_drop);
+  reclaimed = flat() && reclaimed;
+
+  bench::report("drop at co_await, destroyed by the waker", bench::measure(n, [](std::size_t count) {
+    parked p;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      {
+        auto c = await_parked(p);
+      }
+      p.waiter();
+    }
+  }), minimal_drop);
+  reclaimed = flat() && reclaimed;
+
+  run_queue loop;
+  Scheduled::loop = &loop;
+  bench::report("drop while scheduled, destroyed by the loop", bench::measure(n, [&](std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      {
+        auto c = scheduled();
+        loop.run_one(); // up to the first yield
+        (void)c.resume();
+      }
+      loop.run_one();
+    }
+  }), minimal_drop);
+  reclaimed = flat() && reclaimed;
+
+  // a frame left behind is a regression, not a slow run
+  return reclaimed ? 0 : 1;
+}
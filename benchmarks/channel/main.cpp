@@ -0,0 +1,163 @@
+#include <basic_coroutine.hpp>
+#include <channel.hpp>
+#include <work_stealing_executor.hpp>
+
+#include "../measure.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace tmf;
+
+constexpr std::size_t capacity = 1024;
+
+// the usual alternative, a bounded queue blocking OS threads on condition variables
+template<typename T>
+class blocking_queue
+{
+  std::mutex m_mutex;
+  std::condition_variable m_not_full;
+  std::condition_variable m_not_empty;
+  std::deque<T> m_queue;
+  std::size_t m_capacity;
+  bool m_closed{ false };
+
+public:
+  explicit blocking_queue(std::size_t capacity) : m_capacity{ capacity } {}
+
+  void send(T value)
+  {
+    std::unique_lock lock{ m_mutex };
+    m_not_full.wait(lock, [&] { return m_queue.size() < m_capacity; });
+    m_queue.push_back(std::move(value));
+    m_not_empty.notify_one();
+  }
+
+  std::optional<T> recv()
+  {
+    std::unique_lock lock{ m_mutex };
+    m_not_empty.wait(lock, [&] { return !m_queue.empty() || m_closed; });
+    if (m_queue.empty())
+    {
+      return std::nullopt;
+    }
+    T value = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_not_full.notify_one();
+    return value;
+  }
+
+  void close()
+  {
+    std::scoped_lock lock{ m_mutex };
+    m_closed = true;
+    m_not_empty.notify_all();
+  }
+};
+
+std::atomic<std::size_t> finished{ 0 };
+
+// every stage runs on the pool, a parked stage is handed back to it when woken
+struct Stage : basic_coroutine<Stage>
+{
+  static inline work_stealing_executor* pool{ nullptr };
+  void executor(schedule_node& node) { pool->execute(node); }
+  auto on_invoke() { return co_control::resume; }
+  void on_return() { finished.fetch_add(1, std::memory_order_release); }
+};
+
+Stage producer(channel<std::size_t>& ch, std::size_t count, std::atomic<std::size_t>& producing)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    co_await ch.send(i);
+  }
+  if (producing.fetch_sub(1) == 1)
+  {
+    ch.close();
+  }
+}
+
+Stage consumer(channel<std::size_t>& ch)
+{
+  std::size_t sum = 0;
+  while (auto value = co_await ch.recv())
+  {
+    sum += *value;
+  }
+  bench::keep(sum);
+}
+
+// `messages` in total, split evenly between producers
+void coroutines(std::size_t messages, std::size_t producers, std::size_t consumers)
+{
+  channel<std::size_t> ch{ capacity };
+  std::atomic<std::size_t> producing{ producers };
+  finished.store(0);
+  std::vector<Stage> stages;
+  for (std::size_t i = 0; i < consumers; ++i)
+  {
+    stages.push_back(consumer(ch));
+  }
+  for (std::size_t i = 0; i < producers; ++i)
+  {
+    stages.push_back(producer(ch, messages / producers, producing));
+  }
+  while (finished.load(std::memory_order_acquire) != producers + consumers)
+  {
+    std::this_thread::yield();
+  }
+}
+
+void threads(std::size_t messages, std::size_t producers, std::size_t consumers)
+{
+  blocking_queue<std::size_t> queue{ capacity };
+  std::atomic<std::size_t> producing{ producers };
+  std::vector<std::jthread> workers;
+  for (std::size_t i = 0; i < consumers; ++i)
+  {
+    workers.emplace_back([&] {
+      std::size_t sum = 0;
+      while (auto value = queue.recv())
+      {
+        sum += *value;
+      }
+      bench::keep(sum);
+    });
+  }
+  for (std::size_t i = 0; i < producers; ++i)
+  {
+    workers.emplace_back([&] {
+      for (std::size_t k = 0; k < messages / producers; ++k)
+      {
+        queue.send(k);
+      }
+      if (producing.fetch_sub(1) == 1)
+      {
+        queue.close();
+      }
+    });
+  }
+}
+
+int main()
+{
+  constexpr std::size_t n = 2'000'000;
+  work_stealing_executor pool{ 4 };
+  Stage::pool = &pool;
+
+  std::printf("%zu messages, capacity %zu, %zu hardware threads\n", n, capacity, std::size_t{ std::thread::hardware_concurrency() });
+  bench::header("threads+cv");
+  for (auto [producers, consumers, name] : { std::tuple{ 1, 1, "SPSC" }, std::tuple{ 4, 1, "MPSC 4:1" }, std::tuple{ 4, 4, "MPMC 4:4" } })
+  {
+    bench::report(name,
+      bench::measure(n, [&](std::size_t count) { coroutines(count, producers, consumers); }, 3),
+      bench::measure(n, [&](std::size_t count) { threads(count, producers, consumers); }, 3));
+  }
+}
@@ -0,0 +1,99 @@
+#include <basic_coroutine.hpp>
+
+#include "../measure.hpp"
+
+#include <cstdio>
+
+using namespace tmf;
+
+// built once per `BASIC_COROUTINE_CONTRACT` mode, see benchmarks/CMakeLists.txt
+// the hot paths the contract checks sit on: resuming and yielding, awaiting with an `on_await` transform, and creation
+
+template<bool SingleThreaded>
+struct Yielding : basic_coroutine<Yielding<SingleThreaded>>
+{
+  static constexpr bool single_threaded = SingleThreaded;
+  int last{ 0 };
+  auto on_invoke() { return co_control::suspend; }
+  void on_return() {}
+  co_control on_yield(int value)
+  {
+    last = value;
+    return co_control::suspend;
+  }
+};
+
+template<bool SingleThreaded>
+Yielding<SingleThreaded> yielding(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield i;
+  }
+}
+
+struct ready
+{
+  int value;
+  bool await_ready() { return true; }
+  void await_suspend(std::coroutine_handle<>) {}
+  int await_resume() { return value; }
+};
+
+struct Awaiting : basic_coroutine<Awaiting>
+{
+  static constexpr bool single_threaded = true;
+  auto on_invoke() { return co_control::resume; }
+  void on_return() {}
+  // `resume` only passes if the awaited object is ready, this is the check guarding it
+  auto on_await(co_expect<int>) { return co_control::resume; }
+};
+
+Awaiting awaiting(int n, int& sum)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    sum += co_await ready{ i };
+  }
+}
+
+Awaiting created()
+{
+  co_return;
+}
+
+template<bool SingleThreaded>
+double yield_resume(std::size_t count)
+{
+  return bench::measure(count, [](std::size_t n) {
+    auto c = yielding<SingleThreaded>(static_cast<int>(n));
+    int sum = 0;
+    while (c.resume())
+    {
+      sum += c.last;
+    }
+    bench::keep(sum);
+  });
+}
+
+int main()
+{
+  constexpr std::size_t n = 20'000'000;
+  char const* const modes[] = { "?", "throw", "terminate", "unchecked" };
+  std::printf("contract mode: %s\n", modes[BASIC_COROUTINE_CONTRACT]);
+  std::printf("%-44s %12s\n", "case", "ns/op");
+  std::printf("%-44s %12.2f\n", "co_yield -> resume()", yield_resume<false>(n));
+  std::printf("%-44s %12.2f\n", "co_yield -> resume() (single-threaded)", yield_resume<true>(n));
+  std::printf("%-44s %12.2f\n", "co_await, on_await transform", bench::measure(n, [](std::size_t count) {
+    int sum = 0;
+    auto c = awaiting(static_cast<int>(count), sum);
+    bench::keep(sum);
+  }));
+  std::printf("%-44s %12.2f\n", "create + run + destroy", bench::measure(n / 4, [](std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto c = created();
+      bench::keep(c);
+    }
+  }));
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace bench
+{
+
+// keeps the optimizer from discarding a value
+template<typename T>
+inline void keep(T const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// best of `runs` timings, in nanoseconds per iteration
+template<typename F>
+double measure(std::size_t iterations, F&& body, int runs = 5)
+{
+  double best = 1e300;
+  for (int run = 0; run < runs; ++run)
+  {
+    auto start = std::chrono::steady_clock::now();
+    body(iterations);
+    auto stop = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count() / iterations);
+  }
+  return best;
+}
+
+inline void header(char const* against)
+{
+  std::printf("%-44s %12s %12s %9s\n", "case", "ns/op", against, "ratio");
+}
+
+inline void report(char const* name, double ns, double baseline_ns)
+{
+  std::printf("%-44s %12.2f %12.2f %8.2fx\n", name, ns, baseline_ns, ns / baseline_ns);
+}
+
+} // end namespace bench
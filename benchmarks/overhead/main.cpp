@@ -0,0 +1,422 @@
+#include <basic_coroutine.hpp>
+#include <generator.hpp>
+#include <work_stealing_executor.hpp>
+
+#include "../measure.hpp"
+#include "minimal.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+using namespace tmf;
+
+// creation and destruction, the coroutine runs to completion on creation
+template<bool SingleThreaded>
+struct Eager : basic_coroutine<Eager<SingleThreaded>>
+{
+  static constexpr bool single_threaded = SingleThreaded;
+  auto on_invoke() { return co_control::resume; }
+  void on_return() {}
+};
+
+template<bool SingleThreaded>
+Eager<SingleThreaded> eager()
+{
+  co_return;
+}
+
+minimal::eager minimal_eager()
+{
+  co_return;
+}
+
+// `co_yield value` handled by an `on_yield` returning a plain `co_control`
+template<bool SingleThreaded>
+struct Plain : basic_coroutine<Plain<SingleThreaded>>
+{
+  static constexpr bool single_threaded = SingleThreaded;
+  int last{ 0 };
+  auto on_invoke() { return co_control::suspend; }
+  void on_return() {}
+  co_control on_yield(int value)
+  {
+    last = value;
+    return co_control::suspend;
+  }
+};
+
+template<bool SingleThreaded>
+Plain<SingleThreaded> plain(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield i;
+  }
+}
+
+// `co_yield value` handled by an `on_yield` returning a `co_resumer`
+struct Resuming : basic_coroutine<Resuming>
+{
+  int last{ 0 };
+  auto on_invoke() { return co_control::suspend; }
+  void on_return() {}
+  auto on_yield(int value)
+  {
+    last = value;
+    return co_control::suspend >> [this]() { bench::keep(last); };
+  }
+};
+
+Resuming resuming(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield i;
+  }
+}
+
+// `co_yield co_expect<int>::from(value)`, a value travels in each direction
+struct TwoWay : basic_coroutine<TwoWay>
+{
+  int last{ 0 };
+  int input{ 0 };
+  auto on_invoke() { return co_control::suspend; }
+  void on_return() {}
+  auto on_yield(co_expect<int, int> e)
+  {
+    last = e.from;
+    return co_control::suspend >> [this]() { return input; };
+  }
+};
+
+TwoWay two_way(int n)
+{
+  int sum = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    sum += co_yield co_expect<int>::from(i);
+  }
+  bench::keep(sum);
+}
+
+minimal::two_way<int> minimal_two_way(int n)
+{
+  int sum = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    sum += co_yield i;
+  }
+  bench::keep(sum);
+}
+
+// `co_yield nothing`
+struct Nothing : basic_coroutine<Nothing>
+{
+  auto on_invoke() { return co_control::suspend; }
+  void on_return() {}
+  co_control on_yield() { return co_control::suspend; }
+};
+
+Nothing nothing_yields(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield nothing;
+  }
+}
+
+template<typename T>
+minimal::generator<T> minimal_generator(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield i;
+  }
+}
+
+// `tmf::generator`, one value per suspension or a batch of values per suspension
+generator<int> single_values(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield i;
+  }
+}
+
+generator<int> batched_values(int n)
+{
+  std::array<int, 256> batch;
+  for (int i = 0; i < n; i += static_cast<int>(batch.size()))
+  {
+    for (int k = 0; k < static_cast<int>(batch.size()); ++k)
+    {
+      batch[k] = i + k;
+    }
+    co_yield bulk(batch);
+  }
+}
+
+// an awaiter that suspends and immediately asks to be resumed
+struct bounce
+{
+  int value;
+  bool await_ready() { return false; }
+  bool await_suspend(std::coroutine_handle<>) { return false; }
+  int await_resume() { return value; }
+};
+
+// `co_await` through `transforming_awaiter`, with and without an `on_await` interception
+template<bool Intercept>
+struct Awaiting : basic_coroutine<Awaiting<Intercept>>
+{
+  auto on_invoke() { return co_control::resume; }
+  void on_return() {}
+  auto on_await(co_expect<int>) requires Intercept
+  {
+    return co_control::surrender >> [](int n) { return n + 1; };
+  }
+};
+
+template<bool Intercept>
+Awaiting<Intercept> awaiting(int n)
+{
+  int sum = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    sum += co_await bounce{ i };
+  }
+  bench::keep(sum);
+}
+
+minimal::eager minimal_awaiting(int n)
+{
+  int sum = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    sum += co_await bounce{ i };
+  }
+  bench::keep(sum);
+}
+
+// executor dispatch, either run inline or handed to a thread pool at every yield
+struct Inline : basic_coroutine<Inline>
+{
+  template<typename F>
+  void executor(F&& f)
+  {
+    f();
+  }
+  auto on_invoke() { return co_control::suspend; }
+  void on_return() {}
+  co_control on_yield() { return co_control::suspend; }
+};
+
+Inline inline_executed(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield nothing;
+  }
+}
+
+std::atomic<bool> pool_finished{ false };
+
+struct Pooled : basic_coroutine<Pooled>
+{
+  static inline work_stealing_executor* pool{ nullptr };
+  template<typename F>
+  void executor(F&& f)
+  {
+    pool->execute(std::forward<F>(f));
+  }
+  auto on_invoke() { return co_control::resume; }
+  void on_return() { pool_finished.store(true); }
+  co_control on_yield() { return co_control::resume; }
+};
+
+Pooled pooled(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield nothing;
+  }
+}
+
+struct NodePooled : basic_coroutine<NodePooled>
+{
+  static inline work_stealing_executor* pool{ nullptr };
+  void executor(schedule_node& node)
+  {
+    pool->execute(node);
+  }
+  auto on_invoke() { return co_control::resume; }
+  void on_return() { pool_finished.store(true); }
+  co_control on_yield() { return co_control::resume; }
+};
+
+NodePooled node_pooled(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield nothing;
+  }
+}
+
+minimal::scheduled<work_stealing_executor> minimal_pooled(int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    co_yield i;
+  }
+}
+
+template<typename Coroutine>
+void drain(Coroutine& c)
+{
+  while (c.resume())
+  {
+  }
+}
+
+void wait_for_pool()
+{
+  while (!pool_finished.load())
+  {
+    std::this_thread::yield();
+  }
+  pool_finished.store(false);
+}
+
+int main()
+{
+  constexpr std::size_t n = 2'000'000;
+
+  bench::header("hand-written");
+
+  auto minimal_create = bench::measure(n, [](std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto c = minimal_eager();
+      bench::keep(c.handle);
+    }
+  });
+  bench::report("create + run + destroy", bench::measure(n, [](std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto c = eager<false>();
+      bench::keep(c);
+    }
+  }), minimal_create);
+  bench::report("create + run + destroy (single-threaded)", bench::measure(n, [](std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto c = eager<true>();
+      bench::keep(c);
+    }
+  }), minimal_create);
+
+  auto minimal_yield = bench::measure(n, [](std::size_t count) {
+    auto c = minimal_generator<int>(count);
+    drain(c);
+  });
+  bench::report("co_yield value -> co_control", bench::measure(n, [](std::size_t count) {
+    auto c = plain<false>(count);
+    drain(c);
+  }), minimal_yield);
+  bench::report("co_yield value -> co_control (single-threaded)", bench::measure(n, [](std::size_t count) {
+    auto c = plain<true>(count);
+    drain(c);
+  }), minimal_yield);
+  bench::report("co_yield value -> co_resumer", bench::measure(n, [](std::size_t count) {
+    auto c = resuming(count);
+    drain(c);
+  }), minimal_yield);
+  bench::report("co_yield co_expect (two-way)", bench::measure(n, [](std::size_t count) {
+    auto c = two_way(count);
+    drain(c);
+  }), bench::measure(n, [](std::size_t count) {
+    auto c = minimal_two_way(count);
+    drain(c);
+  }));
+  bench::report("co_yield nothing", bench::measure(n, [](std::size_t count) {
+    auto c = nothing_yields(count);
+    drain(c);
+  }), minimal_yield);
+
+  bench::report("tmf::generator, one value per yield", bench::measure(n, [](std::size_t count) {
+    int sum = 0;
+    for (int value : single_values(count))
+    {
+      sum += value;
+    }
+    bench::keep(sum);
+  }), minimal_yield);
+  bench::report("tmf::generator, co_yield bulk (256 per yield)", bench::measure(n, [](std::size_t count) {
+    int sum = 0;
+    for (int value : batched_values(count))
+    {
+      sum += value;
+    }
+    bench::keep(sum);
+  }), minimal_yield);
+  bench::report("tmf::generator, bulk consumed by batch()", bench::measure(n, [](std::size_t count) {
+    int sum = 0;
+    auto values = batched_values(count);
+    for (auto it = values.begin(); it != values.end(); values.consume_batch())
+    {
+      for (int value : values.batch())
+      {
+        sum += value;
+      }
+    }
+    bench::keep(sum);
+  }), minimal_yield);
+
+  auto minimal_await = bench::measure(n, [](std::size_t count) { minimal_awaiting(count); });
+  bench::report("co_await, no on_await", bench::measure(n, [](std::size_t count) { awaiting<false>(count); }),
+    minimal_await);
+  bench::report("co_await, on_await transform", bench::measure(n, [](std::size_t count) { awaiting<true>(count); }),
+    minimal_await);
+
+  auto minimal_rejection = bench::measure(n, [](std::size_t count) {
+    auto c = minimal_generator<int>(0);
+    drain(c);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      bench::keep(c.resume());
+    }
+  });
+  bench::report("resume() rejected", bench::measure(n, [](std::size_t count) {
+    auto c = plain<false>(0);
+    drain(c);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      bench::keep(c.resume());
+    }
+  }), minimal_rejection);
+
+  bench::report("resume() through inline executor", bench::measure(n, [](std::size_t count) {
+    auto c = inline_executed(count);
+    drain(c);
+  }), minimal_yield);
+
+  work_stealing_executor pool{ 1 };
+  Pooled::pool = &pool;
+  minimal::scheduled_promise<work_stealing_executor>::executor = &pool;
+  minimal::scheduled_promise<work_stealing_executor>::finished = &pool_finished;
+  NodePooled::pool = &pool;
+  auto minimal_pooled_dispatch = bench::measure(n, [](std::size_t count) {
+    auto c = minimal_pooled(count);
+    wait_for_pool();
+  });
+  bench::report("resume() through work_stealing_executor", bench::measure(n, [](std::size_t count) {
+    auto c = pooled(count);
+    wait_for_pool();
+  }), minimal_pooled_dispatch);
+  bench::report("resume() through work_stealing_executor, node", bench::measure(n, [](std::size_t count) {
+    auto c = node_pooled(count);
+    wait_for_pool();
+  }), minimal_pooled_dispatch);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// hand-written promise types doing the least work possible for each benchmarked operation
+// they are the floor `basic_coroutine` is compared against
+namespace minimal
+{
+
+template<typename Promise>
+struct owner
+{
+  using promise_type = Promise;
+
+  std::coroutine_handle<Promise> handle;
+
+  owner(std::coroutine_handle<Promise> h) : handle{ h } {}
+  owner(owner&& other) noexcept : handle{ std::exchange(other.handle, nullptr) } {}
+  ~owner()
+  {
+    if (handle)
+    {
+      handle.destroy();
+    }
+  }
+
+  Promise& promise() { return handle.promise(); }
+  bool done() const { return handle.done(); }
+
+  bool resume()
+  {
+    if (handle.done())
+    {
+      return false;
+    }
+    handle.resume();
+    return true;
+  }
+};
+
+struct base_promise
+{
+  std::suspend_always final_suspend() noexcept { return {}; }
+  void unhandled_exception() { std::terminate(); }
+  void return_void() {}
+};
+
+// runs to completion on creation
+struct eager_promise : base_promise
+{
+  owner<eager_promise> get_return_object() { return { std::coroutine_handle<eager_promise>::from_promise(*this) }; }
+  std::suspend_never initial_suspend() { return {}; }
+};
+using eager = owner<eager_promise>;
+
+// yields a value and suspends
+template<typename T>
+struct generator_promise : base_promise
+{
+  T value{};
+  owner<generator_promise> get_return_object() { return { std::coroutine_handle<generator_promise>::from_promise(*this) }; }
+  std::suspend_always initial_suspend() { return {}; }
+  std::suspend_always yield_value(T v)
+  {
+    value = v;
+    return {};
+  }
+};
+template<typename T>
+using generator = owner<generator_promise<T>>;
+
+// yields a value and receives one on resume
+template<typename T>
+struct two_way_promise : base_promise
+{
+  T value{};
+  T input{};
+
+  struct awaiter
+  {
+    two_way_promise* self;
+    bool await_ready() { return false; }
+    void await_suspend(std::coroutine_handle<>) {}
+    T await_resume() { return self->input; }
+  };
+
+  owner<two_way_promise> get_return_object() { return { std::coroutine_handle<two_way_promise>::from_promise(*this) }; }
+  std::suspend_always initial_suspend() { return {}; }
+  awaiter yield_value(T v)
+  {
+    value = v;
+    return { this };
+  }
+};
+template<typename T>
+using two_way = owner<two_way_promise<T>>;
+
+// reschedules itself on `Executor` at every yield, raises `finished` once suspended for the last time
+template<typename Executor>
+struct scheduled_promise : base_promise
+{
+  static inline Executor* executor{ nullptr };
+  static inline std::atomic<bool>* finished{ nullptr };
+
+  struct final_awaiter
+  {
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<>) noexcept { finished->store(true); }
+    void await_resume() noexcept {}
+  };
+
+  struct awaiter
+  {
+    bool await_ready() { return false; }
+    void await_suspend(std::coroutine_handle<> h) { (*executor)([h]() { h.resume(); }); }
+    void await_resume() {}
+  };
+
+  owner<scheduled_promise> get_return_object() { return { std::coroutine_handle<scheduled_promise>::from_promise(*this) }; }
+  awaiter initial_suspend() { return {}; }
+  awaiter yield_value(int) { return {}; }
+  final_awaiter final_suspend() noexcept { return {}; }
+};
+template<typename Executor>
+using scheduled = owner<scheduled_promise<Executor>>;
+
+} // end namespace minimal
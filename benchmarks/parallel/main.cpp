@@ -0,0 +1,66 @@
+#include <generator.hpp>
+#include <parallel.hpp>
+#include <work_stealing_executor.hpp>
+
+#include "../measure.hpp"
+
+#include <cstdint>
+#include <cstdio>
+
+using namespace tmf;
+
+// a CPU-bound sweep, the length of the Collatz sequence of every number in a range, which varies from one number to the next
+// so that shards of equal size take unequal time
+// consumed on the calling thread alone, then by `parallel_consume` over a pool with one worker per hardware thread, split into
+// many more shards than workers so that the uneven ones balance out, per number swept
+
+generator<std::uint64_t> sweep(std::uint64_t first, std::uint64_t last)
+{
+  for (std::uint64_t n = first; n < last; ++n)
+  {
+    co_yield n;
+  }
+}
+
+struct collatz
+{
+  std::uint64_t steps{ 0 };
+
+  void operator()(std::uint64_t n)
+  {
+    for (n += 1; n != 1; n = n % 2 ? 3 * n + 1 : n / 2)
+    {
+      ++steps;
+    }
+  }
+
+  void merge(collatz&& other) { steps += other.steps; }
+};
+
+int main()
+{
+  constexpr std::size_t n = 2'000'000;
+  work_stealing_executor pool{};
+  std::printf("%zu workers\n", pool.size());
+  auto factory = [](std::size_t count) {
+    return [count](shard s) {
+      auto [first, last] = s.bounds(std::uint64_t{ 0 }, std::uint64_t{ count });
+      return sweep(first, last);
+    };
+  };
+  bench::header("one thread");
+  double const single = bench::measure(n, [&](std::size_t count) {
+    collatz sink{};
+    for (std::uint64_t value : sweep(0, count))
+    {
+      sink(value);
+    }
+    bench::keep(sink.steps);
+  }, 3);
+  bench::report("parallel_consume, 1 shard", bench::measure(n, [&](std::size_t count) {
+    bench::keep(parallel_consume(factory(count), 1, pool, collatz{}).steps);
+  }, 3), single);
+  bench::report("parallel_consume, 8 shards per worker", bench::measure(n, [&](std::size_t count) {
+    bench::keep(parallel_consume(factory(count), 8 * pool.size(), pool, collatz{}).steps);
+  }, 3), single);
+}
@@ -0,0 +1,148 @@
+#include <generator.hpp>
+#include <pipeline.hpp>
+
+#include "../measure.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+using namespace tmf;
+
+// five stages over a generator, map, filter, map, take and chunk, once fused into a single pull loop by `tmf::pipeline` and
+// once as a stack of generators, one coroutine per stage pulling from the one below, the baseline is a hand-written loop
+// every case sums the chunks it receives, per value drawn from the source
+
+generator<std::size_t> naturals()
+{
+  for (std::size_t n = 0;; ++n)
+  {
+    co_yield n;
+  }
+}
+
+generator<std::size_t> tripled(generator<std::size_t>& in)
+{
+  for (std::size_t n : in)
+  {
+    co_yield n * 3;
+  }
+}
+
+generator<std::size_t> odd(generator<std::size_t>& in)
+{
+  for (std::size_t const& n : in)
+  {
+    if (n % 2)
+    {
+      co_yield n;
+    }
+  }
+}
+
+generator<std::size_t> incremented(generator<std::size_t>& in)
+{
+  for (std::size_t n : in)
+  {
+    co_yield n + 1;
+  }
+}
+
+generator<std::size_t> first(generator<std::size_t>& in, std::size_t count)
+{
+  for (std::size_t const& n : in)
+  {
+    if (count-- == 0)
+    {
+      break;
+    }
+    co_yield n;
+  }
+}
+
+generator<std::span<std::size_t const>> chunked(generator<std::size_t>& in, std::size_t size)
+{
+  std::vector<std::size_t> buffer;
+  buffer.reserve(size);
+  for (std::size_t n : in)
+  {
+    buffer.push_back(n);
+    if (buffer.size() == size)
+    {
+      co_yield std::span<std::size_t const>{ buffer };
+      buffer.clear();
+    }
+  }
+  if (!buffer.empty())
+  {
+    co_yield std::span<std::size_t const>{ buffer };
+  }
+}
+
+constexpr std::size_t chunk_size = 16;
+
+template<typename Chunks>
+void sum(Chunks&& chunks)
+{
+  std::size_t total = 0;
+  for (std::span<std::size_t const> c : chunks)
+  {
+    for (std::size_t n : c)
+    {
+      total += n;
+    }
+  }
+  bench::keep(total);
+}
+
+int main()
+{
+  // half the values pass the filter, so `count` values drawn from the source make `count / 2` values taken
+  constexpr std::size_t n = 10'000'000;
+  bench::header("loop");
+  double const loop = bench::measure(n, [](std::size_t count) {
+    std::vector<std::size_t> buffer;
+    buffer.reserve(chunk_size);
+    std::size_t total = 0;
+    std::size_t taken = 0;
+    for (std::size_t i = 0; taken < count / 2; ++i)
+    {
+      std::size_t const value = i * 3;
+      if (value % 2 == 0)
+      {
+        continue;
+      }
+      ++taken;
+      buffer.push_back(value + 1);
+      if (buffer.size() == chunk_size)
+      {
+        for (std::size_t v : buffer)
+        {
+          total += v;
+        }
+        buffer.clear();
+      }
+    }
+    for (std::size_t v : buffer)
+    {
+      total += v;
+    }
+    bench::keep(total);
+  });
+  bench::report("fused pipeline", bench::measure(n, [](std::size_t count) {
+    sum(naturals()
+      | tmf::map([](std::size_t n) { return n * 3; })
+      | tmf::filter([](std::size_t n) { return n % 2 != 0; })
+      | tmf::map([](std::size_t n) { return n + 1; })
+      | tmf::take(count / 2)
+      | tmf::chunk(chunk_size));
+  }), loop);
+  bench::report("stack of 6 generators", bench::measure(n, [](std::size_t count) {
+    auto source = naturals();
+    auto a = tripled(source);
+    auto b = odd(a);
+    auto c = incremented(b);
+    auto d = first(c, count / 2);
+    sum(chunked(d, chunk_size));
+  }), loop);
+}
@@ -0,0 +1,107 @@
+#include <run_queue.hpp>
+
+#include "../measure.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace tmf;
+
+// the straightforward alternative to `run_queue`
+class locked_queue
+{
+  std::mutex m_mutex;
+  std::deque<schedule_node*> m_queue;
+
+public:
+  void execute(schedule_node& node)
+  {
+    std::scoped_lock lock{ m_mutex };
+    m_queue.push_back(&node);
+  }
+
+  bool run_one()
+  {
+    schedule_node* node = nullptr;
+    {
+      std::scoped_lock lock{ m_mutex };
+      if (m_queue.empty())
+      {
+        return false;
+      }
+      node = m_queue.front();
+      m_queue.pop_front();
+    }
+    (*node)();
+    return true;
+  }
+};
+
+std::atomic<std::size_t> executed{ 0 };
+
+// `producers` threads each schedule `per_producer` distinct nodes while one consumer drains them
+// returns millions of nodes run per second
+template<typename Queue>
+double throughput(std::size_t producers, std::size_t per_producer)
+{
+  Queue queue;
+  std::vector<std::vector<schedule_node>> nodes(producers);
+  for (auto& batch : nodes)
+  {
+    batch = std::vector<schedule_node>(per_producer);
+    for (auto& node : batch)
+    {
+      node.run = [](schedule_node*) { executed.fetch_add(1, std::memory_order_relaxed); };
+    }
+  }
+  executed.store(0);
+  std::atomic<bool> go{ false };
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&, p]() {
+      while (!go.load())
+      {
+        std::this_thread::yield();
+      }
+      for (auto& node : nodes[p])
+      {
+        queue.execute(node);
+      }
+    });
+  }
+  std::size_t const total = producers * per_producer;
+  auto start = std::chrono::steady_clock::now();
+  go.store(true);
+  while (executed.load(std::memory_order_relaxed) < total)
+  {
+    if (!queue.run_one())
+    {
+      std::this_thread::yield();
+    }
+  }
+  auto stop = std::chrono::steady_clock::now();
+  for (auto& t : threads)
+  {
+    t.join();
+  }
+  return total / std::chrono::duration<double, std::micro>(stop - start).count();
+}
+
+int main()
+{
+  constexpr std::size_t per_producer = 1'000'000;
+  std::size_t const max_producers = std::max(4u, std::thread::hardware_concurrency());
+  std::printf("%-10s %18s %18s\n", "producers", "run_queue Mops/s", "mutex+deque Mops/s");
+  for (std::size_t producers = 1; producers <= max_producers; producers *= 2)
+  {
+    double lock_free = throughput<run_queue>(producers, per_producer);
+    double locked = throughput<locked_queue>(producers, per_producer);
+    std::printf("%-10zu %18.2f %18.2f\n", producers, lock_free, locked);
+  }
+}
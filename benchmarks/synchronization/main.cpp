@@ -0,0 +1,141 @@
+#include <basic_coroutine.hpp>
+#include <synchronization.hpp>
+#include <work_stealing_executor.hpp>
+
+#include "../measure.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <barrier>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+using namespace tmf;
+
+std::atomic<std::size_t> finished{ 0 };
+
+struct Stage : basic_coroutine<Stage>
+{
+  static inline work_stealing_executor* pool{ nullptr };
+  void executor(schedule_node& node) { pool->execute(node); }
+  auto on_invoke() { return co_control::resume; }
+  void on_return() { finished.fetch_add(1, std::memory_order_release); }
+};
+
+std::size_t counter = 0;
+
+Stage locking(async_mutex& mutex, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    auto guard = co_await mutex.scoped_lock();
+    bench::keep(++counter);
+  }
+}
+
+Stage acquiring(async_semaphore& semaphore, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    co_await semaphore.acquire();
+    bench::keep(counter);
+    semaphore.release();
+  }
+}
+
+Stage arriving(async_barrier& barrier, std::size_t phases)
+{
+  for (std::size_t i = 0; i < phases; ++i)
+  {
+    co_await barrier.arrive_and_wait();
+  }
+}
+
+template<typename Start>
+void coroutines(std::size_t stages, Start start)
+{
+  finished.store(0);
+  std::vector<Stage> running;
+  for (std::size_t i = 0; i < stages; ++i)
+  {
+    running.push_back(start());
+  }
+  while (finished.load(std::memory_order_acquire) != stages)
+  {
+    std::this_thread::yield();
+  }
+}
+
+template<typename Body>
+void threads(std::size_t count, Body body)
+{
+  std::vector<std::jthread> workers;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    workers.emplace_back(body);
+  }
+}
+
+int main()
+{
+  constexpr std::size_t n = 1'000'000;
+  constexpr std::size_t stages = 8;
+  work_stealing_executor pool{ 4 };
+  Stage::pool = &pool;
+
+  std::printf("%zu coroutines on 4 workers against %zu threads, %zu hardware threads\n", stages, stages,
+              std::size_t{ std::thread::hardware_concurrency() });
+  bench::header("threads");
+
+  bench::report("async_mutex vs std::mutex",
+    bench::measure(n, [&](std::size_t count) {
+      async_mutex mutex;
+      coroutines(stages, [&] { return locking(mutex, count / stages); });
+    }, 3),
+    bench::measure(n, [&](std::size_t count) {
+      std::mutex mutex;
+      threads(stages, [&] {
+        for (std::size_t i = 0; i < count / stages; ++i)
+        {
+          std::scoped_lock lock{ mutex };
+          bench::keep(++counter);
+        }
+      });
+    }, 3));
+
+  bench::report("async_semaphore(2) vs std::counting_semaphore",
+    bench::measure(n, [&](std::size_t count) {
+      async_semaphore semaphore{ 2 };
+      coroutines(stages, [&] { return acquiring(semaphore, count / stages); });
+    }, 3),
+    bench::measure(n, [&](std::size_t count) {
+      std::counting_semaphore<> semaphore{ 2 };
+      threads(stages, [&] {
+        for (std::size_t i = 0; i < count / stages; ++i)
+        {
+          semaphore.acquire();
+          bench::keep(counter);
+          semaphore.release();
+        }
+      });
+    }, 3));
+
+  // per phase, every participant arrives once
+  constexpr std::size_t phases = 100'000;
+  bench::report("async_barrier vs std::barrier, per phase",
+    bench::measure(phases, [&](std::size_t count) {
+      async_barrier barrier{ stages };
+      coroutines(stages, [&] { return arriving(barrier, count); });
+    }, 3),
+    bench::measure(phases, [&](std::size_t count) {
+      std::barrier barrier{ stages };
+      threads(stages, [&] {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          barrier.arrive_and_wait();
+        }
+      });
+    }, 3));
+}
@@ -0,0 +1,61 @@
+#include <basic_coroutine.hpp>
+#include <task.hpp>
+
+#include "../measure.hpp"
+
+#include <cstdio>
+
+using namespace tmf;
+
+// the cost of `co_await child` where the child returns right away: creating its frame, one transfer into it and one transfer
+// back out of its final suspension point, against calling a function that is not inlined
+
+[[gnu::noinline]] int plain(int value)
+{
+  bench::keep(value);
+  return value + 1;
+}
+
+task<int> child(int value)
+{
+  co_return value + 1;
+}
+
+task<int> nested(int value)
+{
+  co_return co_await child(value) + 1;
+}
+
+struct Driver : basic_coroutine<Driver>
+{
+  static constexpr bool single_threaded = true;
+  auto on_invoke() { return co_control::resume; }
+  void on_return() {}
+};
+
+template<typename Await>
+Driver drive(std::size_t count, Await await)
+{
+  int sum = 0;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    sum += co_await await(static_cast<int>(i));
+  }
+  bench::keep(sum);
+}
+
+int main()
+{
+  constexpr std::size_t n = 10'000'000;
+  bench::header("call");
+  double const call = bench::measure(n, [](std::size_t count) {
+    int sum = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      sum += plain(static_cast<int>(i));
+    }
+    bench::keep(sum);
+  });
+  bench::report("co_await task<int>", bench::measure(n, [](std::size_t count) { drive(count, child); }), call);
+  bench::report("co_await task<int> awaiting another", bench::measure(n, [](std::size_t count) { drive(count, nested); }), call);
+}
@@ -0,0 +1,139 @@
+#include <basic_coroutine.hpp>
+#include <timer_wheel.hpp>
+
+#include "../measure.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <queue>
+#include <random>
+#include <vector>
+
+using namespace tmf;
+using namespace std::chrono_literals;
+
+std::size_t fired{ 0 };
+
+// deadlines spread over `span` milliseconds, the same sequence for every case
+std::vector<timer_wheel::clock::duration> deadlines(std::size_t count, std::size_t span)
+{
+  std::mt19937_64 random{ 42 };
+  std::vector<timer_wheel::clock::duration> result(count);
+  for (auto& deadline : result)
+  {
+    deadline = std::chrono::milliseconds{ 1 + random() % span };
+  }
+  return result;
+}
+
+// walks time forward one millisecond at a time, as a run loop would
+template<typename Advance>
+void tick_through(timer_wheel::clock::time_point start, std::size_t span, Advance&& advance)
+{
+  for (std::size_t ms = 1; ms <= span + 1; ++ms)
+  {
+    advance(start + std::chrono::milliseconds{ ms });
+  }
+}
+
+// the usual alternative, a binary heap ordered by deadline, cancelling is done with a multimap
+struct heap_entry
+{
+  timer_wheel::clock::time_point deadline;
+  timer* t;
+  bool operator>(heap_entry const& other) const { return deadline > other.deadline; }
+};
+
+// a million coroutines each sleeping once
+struct Sleeper : basic_coroutine<Sleeper>
+{
+  static constexpr bool single_threaded = true;
+  auto on_invoke() { return co_control::resume; }
+  void on_return() { ++fired; }
+};
+
+Sleeper sleeper(timer_wheel& wheel, timer_wheel::clock::time_point deadline)
+{
+  co_await sleep_until(wheel, deadline);
+}
+
+int main()
+{
+  constexpr std::size_t n = 1'000'000;
+  constexpr std::size_t span = 10'000; // 10 seconds of 1ms ticks
+  auto const offsets = deadlines(n, span);
+  std::vector<timer> timers(n);
+  for (auto& t : timers)
+  {
+    t.fire = [](timer*) { ++fired; };
+  }
+
+  bench::header("heap");
+
+  auto heap_fire = bench::measure(n, [&](std::size_t count) {
+    std::priority_queue<heap_entry, std::vector<heap_entry>, std::greater<>> heap;
+    auto start = timer_wheel::clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      heap.push({ start + offsets[i], &timers[i] });
+    }
+    tick_through(start, span, [&](timer_wheel::clock::time_point now) {
+      while (!heap.empty() && heap.top().deadline <= now)
+      {
+        heap.top().t->fire(heap.top().t);
+        heap.pop();
+      }
+    });
+  }, 3);
+  bench::report("schedule + fire", bench::measure(n, [&](std::size_t count) {
+    timer_wheel wheel{};
+    auto start = timer_wheel::clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      wheel.schedule(timers[i], start + offsets[i]);
+    }
+    tick_through(start, span, [&](timer_wheel::clock::time_point now) { wheel.advance(now); });
+  }, 3), heap_fire);
+
+  auto map_cancel = bench::measure(n, [&](std::size_t count) {
+    std::multimap<timer_wheel::clock::time_point, timer*> pending;
+    std::vector<std::multimap<timer_wheel::clock::time_point, timer*>::iterator> handles(count);
+    auto start = timer_wheel::clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      handles[i] = pending.emplace(start + offsets[i], &timers[i]);
+    }
+    for (auto handle : handles)
+    {
+      pending.erase(handle);
+    }
+  }, 3);
+  bench::report("schedule + cancel (vs multimap)", bench::measure(n, [&](std::size_t count) {
+    timer_wheel wheel{};
+    auto start = timer_wheel::clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      wheel.schedule(timers[i], start + offsets[i]);
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      wheel.cancel(timers[i]);
+    }
+  }, 3), map_cancel);
+
+  bench::report("co_await sleep_until, 1M coroutines", bench::measure(n, [&](std::size_t count) {
+    timer_wheel wheel{};
+    auto start = timer_wheel::clock::now() + 1h; // far enough that no sleep is ready when awaited
+    std::vector<Sleeper> sleepers;
+    sleepers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      sleepers.push_back(sleeper(wheel, start + offsets[i]));
+    }
+    tick_through(start, span, [&](timer_wheel::clock::time_point now) { wheel.advance(now); });
+  }, 3), heap_fire);
+
+  auto stats = frame_allocations();
+  std::printf("\nframes allocated from upstream: %zu, fired: %zu\n", stats.upstream_allocations, fired);
+}
@@ -0,0 +1,64 @@
+#include <basic_coroutine.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+using namespace tmf;
+
+// measures one `co_yield` -> `resume()` round trip, the hot path of every generator
+template<bool SingleThreaded>
+struct Counter : basic_coroutine<Counter<SingleThreaded>>
+{
+  static constexpr bool single_threaded = SingleThreaded;
+
+  std::int64_t last{ 0 };
+
+  auto on_invoke()
+  {
+    return co_control::suspend;
+  }
+
+  void on_return()
+  {
+  }
+
+  auto on_yield(std::int64_t value)
+  {
+    last = value;
+    return co_control::suspend;
+  }
+};
+
+template<bool SingleThreaded>
+Counter<SingleThreaded> count(std::int64_t n)
+{
+  for (std::int64_t i = 0; i < n; ++i)
+  {
+    co_yield i;
+  }
+}
+
+template<bool SingleThreaded>
+void run(char const* name)
+{
+  constexpr std::int64_t iterations = 20'000'000;
+  auto c = count<SingleThreaded>(iterations);
+  std::int64_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (c.resume())
+  {
+    sum += c.last;
+  }
+  auto stop = std::chrono::steady_clock::now();
+  auto ns = std::chrono::duration<double, std::nano>(stop - start).count();
+  std::cout << name << ":\n";
+  std::cout << "  sizeof(basic_promise): " << sizeof(basic_promise<Counter<SingleThreaded>>) << " bytes\n";
+  std::cout << "  yield/resume round trip: " << ns / iterations << " ns (checksum " << sum << ")\n";
+}
+
+int main()
+{
+  run<false>("thread-safe");
+  run<true>("single-threaded");
+}
@@ -0,0 +1,50 @@
+#include <basic_coroutine.hpp>
+
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <vector>
+
+using namespace tmf;
+
+struct Handler : basic_coroutine<Handler>
+{
+  auto on_invoke() { return co_control::suspend; }
+  auto on_yield() { return co_control::suspend; }
+  void on_return() {}
+};
+
+// a leading `std::allocator_arg_t, Allocator` pair makes the frame come from that allocator
+Handler parse(std::allocator_arg_t, std::pmr::polymorphic_allocator<> memory, int fields)
+{
+  std::pmr::vector<int> parsed{ memory };
+  for (int i = 0; i < fields; ++i)
+  {
+    parsed.push_back(i);
+    co_yield nothing;
+  }
+}
+
+Handler respond(std::allocator_arg_t, std::pmr::polymorphic_allocator<>)
+{
+  co_yield nothing;
+}
+
+// every request gets an arena, its coroutines and what they allocate live in it and are released with it at once
+int main()
+{
+  for (int request = 0; request < 3; ++request)
+  {
+    std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena{ buffer, sizeof(buffer), std::pmr::null_memory_resource() };
+    auto parsing = parse(std::allocator_arg, &arena, 8);
+    auto responding = respond(std::allocator_arg, &arena);
+    while (parsing.resume())
+    {
+    }
+    while (responding.resume())
+    {
+    }
+    std::cout << "request " << request << " done: " << (parsing.done() && responding.done()) << "\n";
+  }
+}
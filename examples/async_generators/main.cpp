@@ -0,0 +1,102 @@
+#include <async_generator.hpp>
+#include <channel.hpp>
+#include <task.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using namespace tmf;
+
+struct record
+{
+  int id;
+  double amount;
+};
+
+// stands in for a reader of a file, lines arrive from another thread whenever they are ready
+// the producer awaits each line between its yields, its consumer is resumed directly by whichever thread completed the read
+async_generator<record> parse(channel<std::string>& lines)
+{
+  while (auto line = co_await lines.recv())
+  {
+    record parsed{};
+    if (std::sscanf(line->c_str(), "%d,%lf", &parsed.id, &parsed.amount) == 2)
+    {
+      co_yield parsed;
+    }
+  }
+}
+
+// a stage, it pulls from the previous one only when its own consumer asks, nothing is buffered in between
+async_generator<record> large(async_generator<record>& records, double threshold)
+{
+  while (record const* r = co_await records.next())
+  {
+    if (r->amount >= threshold)
+    {
+      co_yield *r;
+    }
+  }
+}
+
+task<double> total(async_generator<record>& records)
+{
+  double sum = 0;
+  while (record const* r = co_await records.next())
+  {
+    sum += r->amount;
+  }
+  co_return sum;
+}
+
+// starts a task and keeps it alive
+struct Root : basic_coroutine<Root>
+{
+  auto on_invoke()
+  {
+    return co_control::resume;
+  }
+
+  void on_return()
+  {
+  }
+};
+
+Root run(task<double>& sum, std::atomic<bool>& finished)
+{
+  co_await sum;
+  finished.store(true, std::memory_order_release);
+}
+
+int main()
+{
+  channel<std::string> lines{ 8 };
+  auto records = parse(lines);
+  auto filtered = large(records, 50.0);
+  auto sum = total(filtered);
+  std::atomic<bool> finished{ false };
+  auto root = run(sum, finished);
+
+  std::thread reader{ [&] {
+    for (int i = 0; i < 1000; ++i)
+    {
+      auto line = std::to_string(i) + "," + std::to_string(i % 100) + ".0";
+      while (!lines.try_send(line))
+      {
+        std::this_thread::yield();
+      }
+    }
+    lines.close();
+  } };
+  reader.join();
+  while (!finished.load(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+  // the amounts 50 to 99 of every hundred records
+  double const amount = sum.result();
+  std::printf("total %.1f\n", amount);
+  return amount == 37250.0 ? 0 : 1;
+}
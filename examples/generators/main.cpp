@@ -1,13 +1,18 @@
 #include <basic_coroutine.hpp>
+#include <generator.hpp>
 
 #include <vector>
 #include <iostream>
+#include <ranges>
 
 using namespace tmf;
 
 template<typename T>
 struct Generator : basic_coroutine<Generator<T>>
 {
+  // generators never leave the thread that drives them, this removes all synchronization from the promise
+  static constexpr bool single_threaded = true;
+
   std::vector<T> output;
 
   auto on_invoke()
@@ -72,6 +77,15 @@ Generator<int> fibonacci(bool& stop)
   }
 }
 
+// the library generator, values are read straight out of the suspended frame
+generator<int> naturals(int end)
+{
+  for (int n = 0; n < end; ++n)
+  {
+    co_yield n;
+  }
+}
+
 int main()
 {
   {
@@ -96,4 +110,12 @@ int main()
       std::cout << "\n";
     }
   }
+  {
+    auto odd_squares = naturals(10)
+      | std::views::filter([](int n) { return n % 2 == 1; })
+      | std::views::transform([](int n) { return n * n; });
+    for (auto i : odd_squares)
+      std::cout << i << ' ';
+    std::cout << '\n';
+  }
 }
@@ -0,0 +1,108 @@
+#include <basic_coroutine.hpp>
+#include <reactor.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace tmf;
+
+// a fire-and-forget coroutine, it runs until its first `co_await` on creation and is then driven by the reactor
+struct Io : basic_coroutine<Io>
+{
+  static constexpr bool single_threaded = true;
+
+  auto on_invoke()
+  {
+    return co_control::resume;
+  }
+
+  void on_return()
+  {
+  }
+
+  // every operation goes through here, failures are reported before the coroutine sees them
+  auto on_await(co_expect<io_result>)
+  {
+    return co_control::surrender >> [](io_result result) {
+      if (!result.ok())
+      {
+        std::printf("I/O failed: %s\n", result.error().message().c_str());
+      }
+      return result;
+    };
+  }
+};
+
+// reads whatever arrives on `fd` and writes it back
+Io echo(int fd, std::size_t& echoed)
+{
+  std::byte buffer[64];
+  while (true)
+  {
+    io_result read = co_await async_read(fd, buffer);
+    if (read.bytes() == 0)
+    {
+      break;
+    }
+    co_await async_write(fd, std::span{ buffer, read.bytes() });
+    echoed += read.bytes();
+  }
+  ::close(fd);
+}
+
+// sends `message` and waits for it to come back
+Io ping(int fd, std::string_view message, std::size_t& matched)
+{
+  co_await async_write(fd, std::as_bytes(std::span{ message }));
+  std::vector<std::byte> reply(message.size());
+  std::size_t received = 0;
+  while (received < reply.size())
+  {
+    io_result read = co_await async_read(fd, std::span{ reply }.subspan(received));
+    if (read.bytes() == 0)
+    {
+      break;
+    }
+    received += read.bytes();
+  }
+  if (std::as_bytes(std::span{ message }).size() == received &&
+      std::equal(reply.begin(), reply.end(), std::as_bytes(std::span{ message }).begin()))
+  {
+    ++matched;
+  }
+  ::close(fd);
+}
+
+void run(reactor_backend backend, char const* name)
+{
+  constexpr std::size_t connections = 1000;
+  reactor r{ 256, backend };
+  std::vector<Io> coroutines;
+  std::size_t echoed = 0, matched = 0;
+  for (std::size_t i = 0; i < connections; ++i)
+  {
+    int pair[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, pair) < 0)
+    {
+      std::perror("socketpair");
+      return;
+    }
+    coroutines.push_back(echo(pair[0], echoed));
+    coroutines.push_back(ping(pair[1], "hello from a suspended coroutine", matched));
+  }
+  r.run();
+  std::printf("%s: %zu of %zu pings answered, %zu bytes echoed\n", name, matched, connections, echoed);
+}
+
+int main()
+{
+  run(reactor_backend::automatic, "automatic");
+  run(reactor_backend::epoll, "epoll");
+}
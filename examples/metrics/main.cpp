@@ -0,0 +1,68 @@
+// built with BASIC_COROUTINE_METRICS defined, see examples/CMakeLists.txt
+#include <basic_coroutine.hpp>
+#include <metrics.hpp>
+#include <work_stealing_executor.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace tmf;
+
+std::atomic<int> finished{ 0 };
+work_stealing_executor pool{ 2 };
+
+// every yield goes back through the pool, so each resume is measured from its schedule
+struct Stage : basic_coroutine<Stage>
+{
+  void executor(schedule_node& node) { pool.execute(node); }
+  auto on_invoke() { return co_control::resume; }
+  auto on_yield() { return co_control::resume; }
+  void on_return() { finished.fetch_add(1); }
+};
+
+Stage work(int steps)
+{
+  for (int i = 0; i < steps; ++i)
+  {
+    co_yield nothing;
+  }
+}
+
+void print(char const* name, metrics::histogram_snapshot const& h)
+{
+  std::printf("%-20s n=%-8llu mean=%-8.0f p50=%-8llu p99=%-8llu p99.9=%-8llu max=%llu (ns)\n", name,
+              static_cast<unsigned long long>(h.count), h.mean(), static_cast<unsigned long long>(h.percentile(0.5)),
+              static_cast<unsigned long long>(h.percentile(0.99)), static_cast<unsigned long long>(h.percentile(0.999)),
+              static_cast<unsigned long long>(h.max));
+}
+
+int main()
+{
+  std::vector<Stage> stages;
+  for (int i = 0; i < 16; ++i)
+  {
+    stages.push_back(work(10'000));
+  }
+  // a coroutine queued on the pool cannot be resumed from here, the refusal is counted
+  (void)stages.front().resume();
+  std::printf("queue depth while running: %zu\n", pool.pending());
+  while (finished.load() != 16)
+  {
+    std::this_thread::yield();
+  }
+  // and neither can a finished one
+  (void)stages.front().resume();
+
+  auto report = metrics::snapshot();
+  print("schedule -> resume", report.schedule_to_resume);
+  print("active per resume", report.active);
+  std::printf("rejected resumes: done %llu, active %llu, awaiting %llu, scheduled %llu\n",
+              static_cast<unsigned long long>(report.rejected_for(metrics::rejection::done)),
+              static_cast<unsigned long long>(report.rejected_for(metrics::rejection::active)),
+              static_cast<unsigned long long>(report.rejected_for(metrics::rejection::awaiting)),
+              static_cast<unsigned long long>(report.rejected_for(metrics::rejection::scheduled)));
+  std::printf("live frames: %lld\n", static_cast<long long>(report.live_frames()));
+  return report.rejected_for(metrics::rejection::done) == 1 ? 0 : 1;
+}
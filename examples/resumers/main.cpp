@@ -18,6 +18,8 @@ private:
 
 public:
 
+  static constexpr bool single_threaded = true;
+
   auto on_invoke()
   {
     return co_control::resume;
@@ -1,28 +1,35 @@
 #include "task.hpp"
 
-Task<int> awaited()
+#include <combinators.hpp>
+#include <task.hpp>
+
+// a lazy `tmf::task`, it starts when awaited and resumes its awaiter directly when it returns
+tmf::task<int> computed(int value)
+{
+  co_return value;
+}
+
+Task<int> awaited(int value)
 {
   co_yield nothing;
   co_yield nothing;
   co_yield nothing;
-  co_return 0;
+  co_return co_await computed(value);
 }
 
 Task<int> awaiting()
 {
-  auto cr = awaited();
-  // returns this thread to caller, and suspends this coroutine to resume on
-  // another thread (after the awaited yields or returns), until the awaited returns
-  while (!cr.ready())
-  {
-    co_await cr;
-  }
-  co_return cr.get();
+  auto first = awaited(1);
+  auto second = awaited(2);
+  // returns this thread to caller, and suspends this coroutine until both awaited tasks returned
+  // the last one to return resumes this coroutine, nothing polls
+  co_await when_all(first, second);
+  co_return first.get() + second.get();
 }
 
 int main()
 {
   auto cr = awaiting();
   cr.run();
-  return cr.get();
-}
\ No newline at end of file
+  return cr.get() == 3 ? 0 : 1;
+}
@@ -1,4 +1,5 @@
 #include <basic_coroutine.hpp>
+#include <work_stealing_executor.hpp>
 
 #include <atomic>
 #include <string>
@@ -12,9 +13,9 @@ struct Task : basic_coroutine<Task<T>>
 {
 private:
   inline static int m_instances{0};
+  inline static work_stealing_executor m_pool{};
 
   std::atomic_flag m_ready{};
-  bool m_without_executor{ false };
   T m_value{};
   int m_id;
 
@@ -39,19 +40,11 @@ public:
   ///! <customization points>
 
   // use this to customize how a coroutine-resume is executed
-  // common uses of 
-  template<typename F>
-  void executor(F&& callable)
+  // taking the promise's `schedule_node` instead of a callable lets the pool queue it without allocating
+  void executor(schedule_node& node)
   {
     std::cout << "executor->resuming coroutine: [" << m_id << "]\n\tfrom thread: [" << std::this_thread::get_id() << "]\n";
-    if (m_without_executor)
-    {
-      callable();
-    }
-    else
-    {
-      std::thread{std::forward<F>(callable)}.detach();
-    }
+    m_pool.execute(node);
   }
 
   auto on_invoke()
@@ -104,13 +97,6 @@ public:
     }
   }
 
-  void sync_run()
-  {
-    m_without_executor = true;
-    run();
-    m_without_executor = false;
-  }
-
   bool ready() const
   {
     return m_ready.test();
@@ -124,10 +110,11 @@ public:
 
   bool await_ready() const
   { return false; }
-  void await_suspend(std::coroutine_handle<> h)
+  // runs this task on the awaiting thread until it yields or returns, then hands control back to `h`
+  // both hops are tail calls, so awaiting chains of any depth run in constant stack
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> h)
   {
-    sync_run();
-    h.resume();
+    return this->resume_with(h);
   }
   decltype(auto) await_resume()
   { return *this; }
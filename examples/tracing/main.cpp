@@ -0,0 +1,63 @@
+// built with BASIC_COROUTINE_TRACING defined, see examples/CMakeLists.txt
+#include <basic_coroutine.hpp>
+#include <channel.hpp>
+#include <task.hpp>
+#include <work_stealing_executor.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace tmf;
+
+std::atomic<int> finished{ 0 };
+work_stealing_executor pool{ 2 };
+
+struct Stage : basic_coroutine<Stage>
+{
+  void executor(schedule_node& node) { pool.execute(node); }
+  auto on_invoke() { return co_control::resume; }
+  void on_return() { finished.fetch_add(1); }
+};
+
+task<int> square(int value)
+{
+  co_return value * value;
+}
+
+Stage producer(channel<int>& ch)
+{
+  for (int i = 0; i < 100; ++i)
+  {
+    co_await ch.send(co_await square(i));
+  }
+  ch.close();
+}
+
+Stage consumer(channel<int>& ch, long& sum)
+{
+  while (auto value = co_await ch.recv())
+  {
+    sum += *value;
+  }
+}
+
+// writes trace.json, open it in ui.perfetto.dev or chrome://tracing
+// every thread gets a track, each slice on it is one coroutine running from a resume to its next suspension
+int main()
+{
+  channel<int> ch{ 4 };
+  long sum = 0;
+  auto c = consumer(ch, sum);
+  auto p = producer(ch);
+  while (finished.load() != 2)
+  {
+    std::this_thread::yield();
+  }
+  std::ofstream out{ "trace.json" };
+  trace::write_chrome_json(out);
+  std::cout << "sum " << sum << ", trace written to trace.json\n";
+  return sum == 328350 ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <basic_coroutine.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace tmf
+{
+
+// a lazy stream of the values yielded by a coroutine that may itself `co_await` between its yields
+// consumers pull with `co_await gen.next()`, which runs the producer until its next `co_yield` and hands control back by
+// symmetric transfer, whichever thread the producer was last resumed on, an I/O completion for instance
+// like `generator` nothing is copied or buffered, `next()` yields a pointer to the object where it lives inside the suspended
+// producer, valid until `next()` is awaited again, and null once the producer returned
+// only values of exactly `T` may be yielded, a converted temporary would not outlive the suspension
+// precondition: a single consumer awaits one `next()` at a time, a second `next()` awaited before the first one resumed is
+// undefined, it races with the producer and the contract check in `await_resume` catches some such overlaps, not all of them
+template<typename T>
+class async_generator : public basic_coroutine<async_generator<T>>
+{
+  static_assert(std::is_object_v<T>, "async_generator<T> yields objects, not references");
+
+  T const* m_current{ nullptr };
+  std::exception_ptr m_exception{};
+
+public:
+  using value_type = std::remove_cv_t<T>;
+
+  async_generator() = default;
+  async_generator(async_generator&&) = default;
+  async_generator& operator=(async_generator&&) = default;
+
+  ///! <customization points>
+
+  auto on_invoke()
+  {
+    return co_control::suspend;
+  }
+
+  void on_return()
+  {
+  }
+
+  template<typename U>
+  co_control on_yield(U&& value) requires std::is_same_v<std::remove_cvref_t<U>, value_type>
+  {
+    m_current = std::addressof(value);
+    return co_control::suspend;
+  }
+
+  void on_error(std::exception_ptr e)
+  {
+    m_exception = e;
+  }
+
+  ///! </customization points>
+
+  class next_awaiter
+  {
+    async_generator* m_generator;
+    parked_coroutine m_consumer{};
+
+  public:
+    explicit next_awaiter(async_generator& generator)
+      : m_generator{ &generator }
+    {
+    }
+
+    bool await_ready() { return m_generator->done(); }
+
+    // the consumer is the producer's continuation until its next yield or return, awaits in between do not wake it
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> consumer)
+    {
+      m_generator->m_current = nullptr;
+      m_consumer.park(consumer);
+      return m_generator->resume_with(m_consumer.then());
+    }
+
+    T const* await_resume()
+    {
+      if (m_generator->m_exception)
+      {
+        std::rethrow_exception(std::exchange(m_generator->m_exception, nullptr));
+      }
+      details::expects(
+        [&] { return m_generator->m_current || m_generator->done(); },
+        "[Error]@[Async Generator]: `next()` was awaited while the producer was still running, await one `next()` at a time"
+      );
+      return m_generator->done() ? nullptr : m_generator->m_current;
+    }
+  };
+
+  // `co_await` yields a pointer to the next value, null at the end of the stream
+  next_awaiter next() { return next_awaiter{ *this }; }
+};
+
+} // end namespace tmf
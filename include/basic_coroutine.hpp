@@ -3,10 +3,11 @@
 #include <fwd.hpp>
 #include <details.hpp>
 #include <basic_promise.hpp>
+#include <continuation.hpp>
+#include <metrics.hpp>
 
 #include <concepts>
 #include <coroutine>
-#include <mutex>
 #include <type_traits>
 #include <utility>
 
@@ -25,7 +26,6 @@ private:
 
   basic_coroutine& operator=(handle_type handle)
   {
-    auto lock = handle.promise().lock_future();
     m_handle = handle;
     m_handle.promise().set_future(*this);
     return *this;
@@ -35,55 +35,127 @@ public:
   basic_coroutine() {}
   basic_coroutine(basic_coroutine<Future> const&) = delete;
   basic_coroutine(basic_coroutine<Future>&& moved_from) noexcept
+    : m_handle{ std::exchange(moved_from.m_handle, nullptr) }
   {
-    auto lock = m_handle.promise().lock_future();
-    m_handle = std::exchange(moved_from.m_handle, nullptr);
-    m_handle.promise().set_future(*this);
+    if (m_handle)
+    {
+      m_handle.promise().move_future(*this);
+    }
   }
 
-  virtual ~basic_coroutine()
+  // releases the coroutine currently owned, as the destructor would, then takes over `moved_from`'s
+  basic_coroutine& operator=(basic_coroutine<Future>&& moved_from) noexcept
   {
-    auto lock = m_handle.promise().lock_future();
-    if(m_handle)
+    if (this != &moved_from)
     {
-      m_handle.promise().clear_future();
-      if (m_handle.done())
+      release();
+      m_handle = std::exchange(moved_from.m_handle, nullptr);
+      if (m_handle)
       {
-        m_handle.destroy();
+        m_handle.promise().move_future(*this);
       }
     }
+    return *this;
+  }
+
+protected:
+  // non-virtual, a `basic_coroutine` is only ever a CRTP base and is never deleted through a base pointer
+  // this keeps every future object down to the single handle below
+  ~basic_coroutine()
+  {
+    release();
+  }
+
+private:
+  void release() noexcept
+  {
+    auto handle = std::exchange(m_handle, nullptr);
+    if (handle && handle.promise().clear_future())
+    {
+      handle.destroy();
+    }
+  }
+
+public:
+
+  // does this object own a coroutine? not once default constructed or moved from
+  // an object without one behaves like a coroutine that already returned
+  bool valid() const
+  {
+    return static_cast<bool>(m_handle);
   }
 
   // has this coroutine reached the final supension point?
   bool done() const
   {
-    return m_handle.done();
+    return !m_handle || m_handle.promise().done();
   }
 
   // is this coroutine currently being executed?
   bool active() const
   {
-    return m_handle.promise().active();
+    return m_handle && m_handle.promise().active();
   }
 
   // is this coroutine suspended from a co_await (NOT co_yield) expression
   bool awaiting() const
   {
-    return m_handle.promise().awaiting();
+    return m_handle && m_handle.promise().awaiting();
+  }
+
+  // suspended at a yield point or the initial suspension point, so `resume` and `resume_with` would run it
+  bool resumable() const
+  {
+    return m_handle && m_handle.promise().resumable();
+  }
+
+  // symmetric transfer into this coroutine, meant to be returned from an `await_suspend`
+  // `then` is resumed once, when this coroutine next yields or returns, the executor is bypassed
+  // when this coroutine cannot be resumed `then` is returned instead so the awaiting side never stalls
+  [[nodiscard]] std::coroutine_handle<> resume_with(continuation then)
+  {
+    if (!resumable())
+    {
+      return then();
+    }
+    m_handle.promise().set_continuation(then);
+    return m_handle;
+  }
+
+  [[nodiscard]] std::coroutine_handle<> resume_with(std::coroutine_handle<> awaiting)
+  {
+    return resume_with(continuation::of(awaiting));
   }
 
   // resume the coroutine, if not returned from, and if not busy
   [[nodiscard]] bool resume()
   {
-    if(done() || active() || awaiting())
+    if(!resumable())
     {
+      if constexpr (metrics::enabled)
+      {
+        auto reason = metrics::rejection::scheduled;
+        if (done())
+        {
+          reason = metrics::rejection::done;
+        }
+        else if (active())
+        {
+          reason = metrics::rejection::active;
+        }
+        else if (awaiting())
+        {
+          reason = metrics::rejection::awaiting;
+        }
+        metrics::details::rejected(reason);
+      }
       return false;
     }
     else
     {
       if constexpr (basic_promise<Future>::uses_executor())
       {
-        static_cast<Future&>(*this).executor(std::move([this]() { m_handle.resume(); }));
+        m_handle.promise().schedule();
       }
       else
       {
@@ -94,6 +166,23 @@ public:
   }
 };
 
+namespace details
+{
+
+// the layout of `basic_coroutine` does not depend on `Future`, so one instantiation checked wherever the header is included
+// stands for all of them
+struct layout_probe : basic_coroutine<layout_probe>
+{
+};
+
+using probed = basic_coroutine<layout_probe>;
+static_assert(sizeof(probed) == sizeof(probed::handle_type), "basic_coroutine must be exactly one handle");
+static_assert(alignof(probed) == alignof(probed::handle_type), "basic_coroutine must be aligned as a handle");
+static_assert(!std::is_polymorphic_v<probed>, "basic_coroutine must not carry a vptr");
+static_assert(std::is_standard_layout_v<probed>, "basic_coroutine must be standard layout");
+
+}
+
 } // end namespace tmf
 
 namespace std
@@ -122,7 +211,7 @@ struct coroutine_traits<Future, ArgTs...>
       return tmf::basic_promise<Future>{};
     }
     */
-    
+
     return tmf::basic_promise<Future>{};
   }
 
@@ -2,13 +2,24 @@
 
 #include <fwd.hpp>
 #include <concepts.hpp>
+#include <contract.hpp>
 #include <details.hpp>
+#include <frame_pool.hpp>
+#include <metrics.hpp>
+#include <continuation.hpp>
+#include <schedule_node.hpp>
+#include <tracing.hpp>
 
-#include <atomic>
 #include <coroutine>
+#include <cstdint>
 #include <exception>
-#include <future>
-#include <mutex>
+#include <memory>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace tmf {
@@ -48,6 +59,26 @@ struct co_expect<Expected, void>
 // Use this to yield without providing a value or expecting a value upon resume
 static constexpr co_expect<void, void> nothing{};
 
+// a contiguous batch of values handed to `on_yield(std::span<const T>)` in a single suspension
+template<typename T>
+struct bulk_yield
+{
+  std::span<const T> batch;
+};
+
+// Use this to yield many values at once, as in: `co_yield tmf::bulk(values);`
+template<typename T>
+constexpr bulk_yield<T> bulk(std::span<const T> batch)
+{
+  return { batch };
+}
+
+template<std::ranges::contiguous_range Range>
+constexpr auto bulk(Range const& values)
+{
+  return bulk_yield<std::ranges::range_value_t<Range>>{ std::span{ std::ranges::data(values), std::ranges::size(values) } };
+}
+
 template<typename>
 struct implement_promise_return;
 
@@ -57,7 +88,10 @@ struct implement_promise_return<Promise<Future>>
   void return_void()
   {
     auto& self = static_cast<Promise<Future>&>(*this);
-    self.future().on_return();
+    if (self.has_future())
+    {
+      self.future().on_return();
+    }
   }
 };
 
@@ -72,54 +106,282 @@ struct implement_promise_return<Promise<Future>>
     }
   {
     auto& self = static_cast<Promise<Future>&>(*this);
-    self.future().on_return(std::forward<FwdT>(value));
+    if (self.has_future())
+    {
+      self.future().on_return(std::forward<FwdT>(value));
+    }
+  }
+};
+
+namespace details
+{
+
+// stands in for the `schedule_node` of promises that never meet a node executor
+struct no_schedule_node
+{
+};
+
+// what `basic_promise::operator delete` finds right behind every frame, how to give it back
+// frames of the pool or of `Future::allocate_frame` leave it null, frames of a `std::allocator_arg` allocator release
+// themselves through it, so the promise type is the same whichever way its frame was allocated
+struct frame_trailer
+{
+  void (*release)(void* frame, std::size_t size) noexcept;
+
+  static constexpr std::size_t offset(std::size_t size)
+  {
+    return (size + alignof(frame_trailer) - 1) & ~(alignof(frame_trailer) - 1);
+  }
+
+  // the size of a frame with its trailer
+  static constexpr std::size_t extended(std::size_t size) { return offset(size) + sizeof(frame_trailer); }
+
+  static void* attach(void* frame, std::size_t size, void (*release)(void*, std::size_t) noexcept)
+  {
+    ::new (static_cast<void*>(static_cast<unsigned char*>(frame) + offset(size))) frame_trailer{ release };
+    return frame;
+  }
+
+  static frame_trailer const& of(void* frame, std::size_t size)
+  {
+    return *std::launder(reinterpret_cast<frame_trailer const*>(static_cast<unsigned char*>(frame) + offset(size)));
+  }
+};
+
+// carves frames from a user supplied allocator, the allocator is stored right behind the frame trailer, where the size of the
+// frame, which is passed back to `operator delete`, tells where to find it again
+// an allocator whose instances are all equal is not stored at all
+template<typename Allocator>
+struct frame_allocator
+{
+  struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) block
+  {
+    unsigned char bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+  };
+
+  using block_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<block>;
+  using traits = std::allocator_traits<block_allocator>;
+
+  static_assert(std::is_pointer_v<typename traits::pointer>, "frame allocators must hand out raw pointers");
+  static_assert(alignof(block_allocator) <= alignof(block), "the allocator is stored behind the frame, it cannot be over-aligned");
+
+  static constexpr bool stored = !(traits::is_always_equal::value && std::is_default_constructible_v<block_allocator>);
+
+  static constexpr std::size_t allocator_offset(std::size_t size)
+  {
+    return (frame_trailer::extended(size) + alignof(block_allocator) - 1) & ~(alignof(block_allocator) - 1);
+  }
+
+  static constexpr std::size_t blocks(std::size_t size)
+  {
+    std::size_t const bytes = stored ? allocator_offset(size) + sizeof(block_allocator) : frame_trailer::extended(size);
+    return (bytes + sizeof(block) - 1) / sizeof(block);
+  }
+
+  static void* allocate(std::size_t size, Allocator const& allocator)
+  {
+    block_allocator rebound(allocator);
+    block* frame = traits::allocate(rebound, blocks(size));
+    if constexpr (stored)
+    {
+      ::new (static_cast<void*>(reinterpret_cast<unsigned char*>(frame) + allocator_offset(size))) block_allocator(std::move(rebound));
+    }
+    return frame_trailer::attach(frame, size, &deallocate);
+  }
+
+  static void deallocate(void* ptr, std::size_t size) noexcept
+  {
+    if constexpr (stored)
+    {
+      auto* kept = std::launder(reinterpret_cast<block_allocator*>(static_cast<unsigned char*>(ptr) + allocator_offset(size)));
+      block_allocator rebound(std::move(*kept));
+      kept->~block_allocator();
+      traits::deallocate(rebound, static_cast<block*>(ptr), blocks(size));
+    }
+    else
+    {
+      block_allocator rebound{};
+      traits::deallocate(rebound, static_cast<block*>(ptr), blocks(size));
+    }
   }
 };
 
+}
+
 template<typename Future>
-struct basic_promise : public implement_promise_return<basic_promise<Future>>
+struct basic_promise
+  : public implement_promise_return<basic_promise<Future>>
+  , private std::conditional_t<NodeScheduledFuture<Future>, schedule_node, details::no_schedule_node>
 {
 private:
 
+  // the lifecycle of a coroutine is a single word of flags, every transition is one atomic operation
+  // a `SingleThreadedFuture` gets a plain integer instead and no synchronization at all
+  // `active`, `awaiting`, `scheduled` and `done` are only changed by the thread that runs or resumes the coroutine, whoever
+  // drops the future object only clears `has_future`, so a transition knows the flags it flips
+  enum state_flag : std::uint32_t
+  {
+    state_has_future = 1u << 0,
+    state_active = 1u << 1,
+    state_awaiting = 1u << 2,
+    state_done = 1u << 3,
+    state_scheduled = 1u << 4, // handed to the executor, not yet running
+  };
+
   basic_coroutine<Future>* m_future{ nullptr };
 
-  std::atomic_flag m_active{}, m_awaiting{}, m_exception_thrown{};
+  details::state_word<!SingleThreadedFuture<Future>> m_state{};
+
+  continuation m_continuation{};
 
-  std::mutex m_mutex;
+  [[no_unique_address]] metrics::details::promise_clock m_clock{};
 
+  // claims a resumed coroutine for the running thread with a single `lock bts`, a second thread resuming it finds the flag set
+  // the scheduled or awaiting flag is only cleared afterwards, so a dropped future always finds at least one flag telling it
+  // somebody else still holds the handle
+  // a coroutine whose future object was dropped meanwhile still runs, it is destroyed at its next suspension point, resumers
+  // that go through `unpark` destroy it before it runs at all
   void activate()
   {
-    if (m_active.test_and_set())
+    bool const was_active = m_state.set(state_active) & state_active;
+    details::expects(
+      [&] { return !was_active; },
+      "[Error][Coroutine Promise]: attempted to resume an active coroutine"
+      ", coroutine execution may only be transferred to a single thread at a time"
+    );
+    if (auto const parked = m_state.load() & (state_scheduled | state_awaiting))
     {
-      throw std::runtime_error(
-        "[Error][Coroutine Promise]: attempted to resume an active coroutine"
-        ", coroutine execution may only be transferred to a single thread at a time"
-      );
+      m_state.clear(parked);
     }
+    BASIC_COROUTINE_TRACE(resume, this);
+    m_clock.activated();
+  }
+  // suspends at a yield point, returns whether the future object was still attached at the moment of suspension
+  // while the coroutine runs nothing else writes its state, the future object is never dropped from another thread meanwhile,
+  // so unlike `activate` this takes a plain store and the yield/resume round trip a single locked instruction
+  bool deactivate()
+  {
+    BASIC_COROUTINE_TRACE(suspend, this);
+    m_clock.suspended();
+    auto const previous = m_state.load();
+    m_state.store(previous & ~state_active);
+    return previous & state_has_future;
+  }
+  // marks the final suspension point, returns whether the future object was still attached
+  bool finish()
+  {
+    BASIC_COROUTINE_TRACE(suspend, this);
+    m_clock.suspended();
+    return m_state.transition(state_done, state_active) & state_has_future;
   }
-  void deactivate() { m_active.clear(); }
 
-  void await_value()
+  // suspends at a yield point and picks the coroutine to transfer to
+  // the continuation is taken before the future is released, afterwards the frame may already be gone
+  std::coroutine_handle<> yield_to_continuation(std::coroutine_handle<> handle)
   {
-    m_awaiting.test_and_set();
+    auto next = std::exchange(m_continuation, {});
+    if (!deactivate())
+    {
+      handle.destroy();
+    }
+    return next();
   }
-  void recieve_value()
+
+  // suspends at a yield point and hands the next resume straight to the executor
+  // returns false when the future was dropped while running, the caller then destroys the frame instead
+  bool reschedule()
   {
-    m_awaiting.clear();
+    BASIC_COROUTINE_TRACE(suspend, this);
+    m_clock.suspended();
+    auto previous = m_state.transition(state_scheduled, state_active);
+    if (!(previous & state_has_future))
+    {
+      return false;
+    }
+    dispatch();
+    return true;
   }
 
+  void dispatch()
+  {
+    m_clock.scheduled();
+    if constexpr (NodeScheduledFuture<Future>)
+    {
+      schedule_node& node = *this;
+      node.next.store(nullptr, std::memory_order_relaxed);
+      node.run = [](schedule_node* scheduled)
+      {
+        static_cast<basic_promise<Future>&>(*scheduled).unpark().resume();
+      };
+      future().executor(node);
+    }
+    else
+    {
+      auto handle = std::coroutine_handle<basic_promise<Future>>::from_promise(*this);
+      future().executor([handle]() { handle.promise().unpark().resume(); });
+    }
+  }
+
+  // suspends in a `co_await`, returns whether the future object was still attached at the moment of suspension
+  bool await_value()
+  {
+    BASIC_COROUTINE_TRACE(suspend, this);
+    m_clock.suspended();
+    return m_state.transition(state_awaiting, state_active) & state_has_future;
+  }
+
+  // what a customization point called from the coroutine body returns, nothing once the future object was dropped while the
+  // coroutine was running, it is then destroyed at the suspension point it is about to reach
+  template<typename Customization>
+  auto resumer_of(Customization&& customization) -> std::optional<decltype(customization(std::declval<Future&>()))>
+  {
+    if (!has_future()) [[unlikely]]
+    {
+      return std::nullopt;
+    }
+    return customization(future());
+  }
+
+  template<typename Optional>
+  using resumer_type = typename Optional::value_type;
+
 public:
 
-  [[nodiscard]] bool has_future() const { return m_future != nullptr; }
+  [[nodiscard]] bool has_future() const { return m_state.load() & state_has_future; }
   Future& future() const { return static_cast<Future&>(*m_future); }
-  void set_future(basic_coroutine<Future>& init) { m_future = &init; }
-  void clear_future() { m_future = nullptr; }
+  void set_future(basic_coroutine<Future>& init)
+  {
+    m_future = &init;
+    m_state.set(state_has_future);
+  }
+  // rebinds the future object after it has been moved, the coroutine must not be running on another thread
+  void move_future(basic_coroutine<Future>& init) { m_future = &init; }
+  // detaches the future object, returns true when the caller is now responsible for destroying the frame
+  // that is when the coroutine finished, or sits at a yield point where nothing else can resume it
+  // a coroutine that is scheduled or awaiting is left to whoever resumes it, see `unpark`, a running one is destroyed at its
+  // next suspension point
+  [[nodiscard]] bool clear_future()
+  {
+    auto previous = m_state.clear(state_has_future);
+    return (previous & state_done) || !(previous & (state_active | state_awaiting | state_scheduled));
+  }
+
+  // `then` is resumed the next time this coroutine yields or returns, it is used once
+  void set_continuation(continuation then) { m_continuation = then; }
 
-  bool active() const { return m_active.test(); }
+  bool active() const { return m_state.load() & state_active; }
 
-  bool awaiting() const { return m_awaiting.test(); }
+  bool awaiting() const { return m_state.load() & state_awaiting; }
 
-  [[nodiscard]] auto lock_future() { return std::move(std::unique_lock<std::mutex>{ m_mutex }); }
+  bool done() const { return m_state.load() & state_done; }
+
+  bool scheduled() const { return m_state.load() & state_scheduled; }
+
+  // suspended at a yield point or the initial suspension point, checked with a single load
+  bool resumable() const
+  {
+    return !(m_state.load() & (state_active | state_awaiting | state_done | state_scheduled));
+  }
 
   static constexpr bool uses_executor()
   {
@@ -129,10 +391,107 @@ public:
       []<typename F> requires requires(F& f) { f.executor([]() {}); }
         () constexpr { return true; }
     }.check(tmf::details::typle<Future>{});
-    return result;
+    return result || NodeScheduledFuture<Future>;
+  }
+
+  // hands the next resume of this coroutine to `Future::executor`
+  // a node executor receives the `schedule_node` embedded in this promise, so nothing is allocated
+  void schedule()
+  {
+    m_state.set(state_scheduled);
+    dispatch();
+  }
+
+  // resumes a coroutine parked in a `co_await`, for awaited objects that hold on to its handle
+  // with an executor the resume is handed to it, so the coroutine carries on where it is meant to run
+  void wake()
+  {
+    if constexpr (uses_executor())
+    {
+      if (has_future())
+      {
+        schedule();
+        return;
+      }
+    }
+    unpark().resume();
+  }
+
+  // the coroutine to transfer to in order to resume this one, for whoever resumes it out of a `co_await` or on its executor
+  // when the future object was dropped meanwhile nothing may run the coroutine any more, so its frame is destroyed right
+  // here and `std::noop_coroutine()` returned instead
+  std::coroutine_handle<> unpark()
+  {
+    auto handle = std::coroutine_handle<basic_promise<Future>>::from_promise(*this);
+    if (!has_future()) [[unlikely]]
+    {
+      handle.destroy();
+      return std::noop_coroutine();
+    }
+    return handle;
+  }
+
+  // a `Future` may supply its own frame allocator by declaring both
+  // `static void* allocate_frame(std::size_t)` and `static void deallocate_frame(void*, std::size_t) noexcept`
+  // otherwise frames come from a thread-local size-class pool, see `tmf::frame_allocations()`
+  static constexpr bool uses_frame_allocator()
+  {
+    return requires(void* ptr, std::size_t size)
+    {
+      { Future::allocate_frame(size) } -> std::same_as<void*>;
+      Future::deallocate_frame(ptr, size);
+    };
+  }
+
+  // every frame carries a `details::frame_trailer`, the sizes the pool or `Future::allocate_frame` see include it
+  static void* operator new(std::size_t size)
+  {
+    metrics::details::frame_created();
+    if constexpr (uses_frame_allocator())
+    {
+      return details::frame_trailer::attach(Future::allocate_frame(details::frame_trailer::extended(size)), size, nullptr);
+    }
+    else
+    {
+      return details::frame_trailer::attach(details::allocate_pooled_frame(details::frame_trailer::extended(size)), size, nullptr);
+    }
+  }
+
+  // a coroutine declared with a leading `std::allocator_arg_t, Allocator` parameter pair, after the object parameter for
+  // member functions, has its frame carved from that allocator instead
+  template<typename Allocator, typename... ArgTs>
+  static void* operator new(std::size_t size, std::allocator_arg_t, Allocator const& allocator, ArgTs const&...)
+  {
+    metrics::details::frame_created();
+    return details::frame_allocator<Allocator>::allocate(size, allocator);
+  }
+
+  template<typename Self, typename Allocator, typename... ArgTs>
+  static void* operator new(std::size_t size, Self const&, std::allocator_arg_t, Allocator const& allocator, ArgTs const&...)
+  {
+    return operator new(size, std::allocator_arg, allocator);
+  }
+
+  static void operator delete(void* ptr, std::size_t size) noexcept
+  {
+    metrics::details::frame_destroyed();
+    if (auto release = details::frame_trailer::of(ptr, size).release)
+    {
+      release(ptr, size);
+    }
+    else if constexpr (uses_frame_allocator())
+    {
+      Future::deallocate_frame(ptr, details::frame_trailer::extended(size));
+    }
+    else
+    {
+      details::deallocate_pooled_frame(ptr, details::frame_trailer::extended(size));
+    }
   }
 
   basic_promise() {}
+  // a frame destroyed with a continuation still registered, abandoned while it awaited, never reaches it
+  ~basic_promise() { m_continuation.discard(); }
   basic_promise(const basic_promise<Future>&) = delete;
   void operator=(const basic_promise<Future>&) = delete;
 
@@ -179,36 +538,27 @@ public:
         return is_resuming(resumer);
       }
     }
-    void await_suspend(std::coroutine_handle<> handle)
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<>)
     {
-      auto lock = self->lock_future();
-      if (!self->has_future())
-      {
-        throw std::runtime_error(
-                "[Error]@[Coroutine Promise][Initial Suspend Awaiter]: missing future object"
-        );
-      }
-      self->deactivate();
+      details::expects(
+        [this] { return self->has_future(); },
+        "[Error]@[Coroutine Promise][Initial Suspend Awaiter]: missing future object"
+      );
+      // the coroutine never ran, there is no active flag to clear
       if constexpr (uses_executor())
       {
         if (is_resuming(resumer))
         {
-          self->future().executor(std::move([=]() { handle.resume(); }));
+          self->schedule();
         }
       }
+      return std::noop_coroutine();
     }
     void await_resume()
     {
-      auto lock = self->lock_future();
-      if (self->has_future()) {
-        self->activate();
-        if constexpr (Specializes<Resumer, co_resumer>)
-          resumer.on_resume();
-      } else {
-        throw std::runtime_error(
-          "[Error]@[Coroutine Promise][Initial Suspend Awaiter]: missing future object"
-        );
-      }
+      self->activate();
+      if constexpr (Specializes<Resumer, co_resumer>)
+        resumer.on_resume();
     }
 };
 // END INTITIAL AWAITER
@@ -216,6 +566,7 @@ public:
 auto
 initial_suspend()
 {
+  BASIC_COROUTINE_TRACE(invoke, this);
   auto resumer = future().on_invoke();
   return initial_awaiter_type<decltype(resumer)>{ this, std::move(resumer) };
 }
@@ -228,15 +579,14 @@ struct final_awaiter_type
   {
     return false;
   }
-  void await_suspend(std::coroutine_handle<> handle) noexcept
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle) noexcept
   {
-    auto lock = self->lock_future();
-    self->deactivate();
-    if (!self->has_future())
+    auto next = std::exchange(self->m_continuation, {});
+    if (!self->finish())
     {
       handle.destroy();
-      return;
     }
+    return next();
   }
   void await_resume() noexcept {}
 };
@@ -245,6 +595,7 @@ struct final_awaiter_type
 auto
 final_suspend() noexcept
 {
+  BASIC_COROUTINE_TRACE(finish, this);
   return final_awaiter_type{ this };
 }
 
@@ -259,14 +610,10 @@ unhandled_exception()
     { { f.on_error(e) } -> std::same_as<void>; }
     () constexpr { return true; }
   }.check(typle<Future>{});
+  // without a future there is nobody left to report to
   if constexpr (has_error_customization) {
-    auto lock = lock_future();
     if (has_future()) {
       future().on_error(std::current_exception());
-    } else {
-      throw std::runtime_error(
-        "[Error]@[Coroutine Promise][Unhandled Exception Handler]: missing future object"
-      );
     }
   }
 }
@@ -276,7 +623,7 @@ template<typename Yielding, typename Resumer>
 struct yield_only_awaiter_type
 {
   basic_promise<Future>* const self;
-  Resumer resumer;
+  std::optional<Resumer> resumer; // none once the future object was dropped, the coroutine is destroyed when it suspends
 
   bool is_resuming(co_control control)
   {
@@ -303,43 +650,35 @@ struct yield_only_awaiter_type
     }
     else
     {
-      return is_resuming(resumer);
+      return resumer && is_resuming(*resumer);
     }    
   }
-  void await_suspend(std::coroutine_handle<> handle)
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle)
   {
-    auto lock = self->lock_future();
-    self->deactivate();
-    if (!self->has_future())
-    {
-      handle.destroy();
-      return;
-    }
     if constexpr (uses_executor())
     {
-      if (is_resuming(resumer))
+      if (resumer && is_resuming(*resumer))
       {
-        self->future().executor([=]() { handle.resume(); });
+        // the coroutine keeps running on its executor, so nobody is handed control yet
+        if (!self->reschedule())
+        {
+          handle.destroy();
+        }
+        return std::noop_coroutine();
       }
     }
+    return self->yield_to_continuation(handle);
   }
   decltype(auto) await_resume()
   {
-    auto lock = self->lock_future();
-    if constexpr (Specializes<Resumer, co_resumer>)
+    // a yield that did not suspend never stopped running
+    if (!await_ready())
     {
-      if (!self->has_future()) {
-        throw std::runtime_error(
-          "[Error]@[Coroutine Promise][Yield-Only Awaiter]: missing future object"
-        );
-      }
       self->activate();
-      resumer.on_resume();
-      return;
     }
-    else
+    if constexpr (Specializes<Resumer, co_resumer>)
     {
-      return;
+      resumer->on_resume();
     }
   }
 };
@@ -349,13 +688,14 @@ struct yield_only_awaiter_type
 template<typename Yielding>
 auto yield_value(Yielding&& value) requires
   (!Specializes<Yielding, co_expect>) // co_expect<void, T> is too verbose
+  && (!Specializes<std::remove_cvref_t<Yielding>, bulk_yield>)
   &&
   requires(Future& f, Yielding&& v)
   { { f.on_yield(std::forward<Yielding>(v)) } -> std::same_as<co_control>; }
 {
-  auto lock = lock_future();
-  auto resumer = future().on_yield(std::forward<Yielding>(value));
-  return yield_only_awaiter_type<Yielding&&, decltype(resumer)>
+  BASIC_COROUTINE_TRACE(yield, this);
+  auto resumer = resumer_of([&](Future& f) { return f.on_yield(std::forward<Yielding>(value)); });
+  return yield_only_awaiter_type<Yielding&&, resumer_type<decltype(resumer)>>
   {
     this,
     std::move(resumer)
@@ -366,13 +706,31 @@ auto yield_value(Yielding&& value) requires
 template<typename Yielding>
 auto yield_value(Yielding&& value) requires
   (!Specializes<Yielding, co_expect>)
+  && (!Specializes<std::remove_cvref_t<Yielding>, bulk_yield>)
   &&
   requires(Future& f, Yielding&& v)
   { { f.on_yield(std::forward<Yielding>(v)) } -> Specializes<co_resumer>; }
 {
-  auto lock = lock_future();
-  auto resumer = future().on_yield(std::forward<Yielding>(value));
-  return yield_only_awaiter_type<Yielding&&, decltype(resumer)>
+  BASIC_COROUTINE_TRACE(yield, this);
+  auto resumer = resumer_of([&](Future& f) { return f.on_yield(std::forward<Yielding>(value)); });
+  return yield_only_awaiter_type<Yielding&&, resumer_type<decltype(resumer)>>
+  {
+    this,
+    std::move(resumer)
+  };
+}
+
+// yield a batch of values in one suspension, the span stays valid until the coroutine is resumed
+template<typename T>
+auto yield_value(bulk_yield<T> values) requires
+  requires(Future& f, std::span<const T> batch)
+  { { f.on_yield(batch) } -> std::same_as<co_control>; }
+  || requires(Future& f, std::span<const T> batch)
+  { { f.on_yield(batch) } -> Specializes<co_resumer>; }
+{
+  BASIC_COROUTINE_TRACE(yield, this);
+  auto resumer = resumer_of([&](Future& f) { return f.on_yield(values.batch); });
+  return yield_only_awaiter_type<std::span<const T>, resumer_type<decltype(resumer)>>
   {
     this,
     std::move(resumer)
@@ -384,7 +742,7 @@ template<typename Expecting, typename Yielding, typename Resumer>
 struct two_way_yield_awaiter_type
 {
   basic_promise<Future>* const self;
-  Resumer resumer;
+  std::optional<Resumer> resumer; // none once the future object was dropped, the coroutine is destroyed when it suspends
 
   bool is_resuming(co_control control)
   {
@@ -411,36 +769,33 @@ struct two_way_yield_awaiter_type
     }
     else
     {
-      return is_resuming(resumer);
+      return resumer && is_resuming(*resumer);
     }
   }
-  void await_suspend(std::coroutine_handle<> handle)
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle)
   {
-    auto lock = self->lock_future();
-    self->deactivate();
-    if (!self->has_future())
-    {
-      handle.destroy();
-      return;
-    }
     if constexpr (uses_executor())
     {
-      if (is_resuming(resumer))
+      if (resumer && is_resuming(*resumer))
       {
-        self->future().executor(std::move([=]() { handle.resume(); }));
+        // the coroutine keeps running on its executor, so nobody is handed control yet
+        if (!self->reschedule())
+        {
+          handle.destroy();
+        }
+        return std::noop_coroutine();
       }
     }
+    return self->yield_to_continuation(handle);
   }
   Expecting await_resume()
   {
-    auto lock = self->lock_future();
-    if (!self->has_future()) {
-      throw std::runtime_error(
-        "[Error]@[Coroutine Promise][2-Way Yield Awaiter]: missing future object"
-      );
+    // a yield that did not suspend never stopped running
+    if (!await_ready())
+    {
+      self->activate();
     }
-    self->activate();
-    return resumer.on_resume();
+    return resumer->on_resume();
   }
 };
 // END 2-WAY YIELD AWAITER
@@ -455,9 +810,11 @@ yield_value(co_expect<Expecting, Yielding> e) requires
     { f.on_yield(co_expect<Expecting>::from(y)) } -> Specializes<co_resumer>;
   }
 {
-  auto lock = lock_future();
-  auto resumer = future().on_yield(std::move(co_expect<Expecting>::from(static_cast<Yielding>(e.from))));
-  return two_way_yield_awaiter_type<Expecting, Yielding, decltype(resumer)>
+  BASIC_COROUTINE_TRACE(yield, this);
+  auto resumer = resumer_of([&](Future& f) {
+    return f.on_yield(std::move(co_expect<Expecting>::from(static_cast<Yielding>(e.from))));
+  });
+  return two_way_yield_awaiter_type<Expecting, Yielding, resumer_type<decltype(resumer)>>
   { 
     this,
     std::move(resumer)
@@ -469,7 +826,7 @@ template<typename Expecting, typename Resumer>
 struct void_yield_awaiter_type
 {
   basic_promise<Future>* const self;
-  Resumer resumer;
+  std::optional<Resumer> resumer; // none once the future object was dropped, the coroutine is destroyed when it suspends
 
   bool is_resuming(co_control control)
   {
@@ -496,37 +853,34 @@ struct void_yield_awaiter_type
     }
     else
     {
-      return is_resuming(resumer);
+      return resumer && is_resuming(*resumer);
     }
   }
-  void await_suspend(std::coroutine_handle<> handle)
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle)
   {
-    auto lock = self->lock_future();
-    self->deactivate();
-    if (!self->has_future())
-    {
-      handle.destroy();
-      return;
-    }
     if constexpr (uses_executor())
     {
-      if (is_resuming(resumer))
+      if (resumer && is_resuming(*resumer))
       {
-        self->future().executor(std::move([=]() { handle.resume(); }));
+        // the coroutine keeps running on its executor, so nobody is handed control yet
+        if (!self->reschedule())
+        {
+          handle.destroy();
+        }
+        return std::noop_coroutine();
       }
     }
+    return self->yield_to_continuation(handle);
   }
   Expecting await_resume()
   {
-    auto lock = self->lock_future();
-    if (!self->has_future()) {
-      throw std::runtime_error(
-        "[Error][Coroutine Promise][Void Yield Awaiter]: missing future object"
-      );
+    // a yield that did not suspend never stopped running
+    if (!await_ready())
+    {
+      self->activate();
     }
-    self->activate();
     if constexpr (Specializes<Resumer, co_resumer>)
-      return resumer.on_resume();
+      return resumer->on_resume();
     else
     {
       static_assert(std::is_same_v<Expecting, void>, "yield handler expects a value upon resume, implement a resumer");
@@ -542,9 +896,9 @@ auto yield_value(co_expect<void, void> exp) requires
     { f.on_yield() } -> std::same_as<co_control>;
   }
 {
-  auto lock = lock_future();
-  auto resumer = future().on_yield();
-  return void_yield_awaiter_type<void, decltype(resumer)>{ this, std::move(resumer) };
+  BASIC_COROUTINE_TRACE(yield, this);
+  auto resumer = resumer_of([](Future& f) { return f.on_yield(); });
+  return void_yield_awaiter_type<void, resumer_type<decltype(resumer)>>{ this, std::move(resumer) };
 }
 
 template<typename Expecting>
@@ -554,9 +908,9 @@ auto yield_value(co_expect<Expecting, void> exp) requires
     { f.on_yield(co_expect<Expecting, void>{}) } -> std::same_as<co_control>;
   }
 {
-  auto lock = lock_future();
-  auto resumer = future().on_yield(co_expect<Expecting>{});
-  return void_yield_awaiter_type<Expecting, decltype(resumer)>{ this, std::move(resumer) };
+  BASIC_COROUTINE_TRACE(yield, this);
+  auto resumer = resumer_of([](Future& f) { return f.on_yield(co_expect<Expecting>{}); });
+  return void_yield_awaiter_type<Expecting, resumer_type<decltype(resumer)>>{ this, std::move(resumer) };
 }
 
 // BEGIN TRANSFORMING AWAITER
@@ -585,24 +939,24 @@ struct transforming_awaiter
 {
   basic_promise<Future>* const self;
   WrappedAwaiter wrapped;
-  Resumer resumer;
+  std::optional<Resumer> resumer; // none once the future object was dropped, the coroutine is destroyed when it suspends
 
-  bool await_ready()
+  bool await_ready() noexcept(noexcept(wrapped.await_ready()) && !contract_throws)
   {
     if(self->awaiting())
       return false;
     if constexpr (has_await_wrapper<Recievable>()) {
+      if (!resumer)
+        return false;
       bool is_resuming = wrapped.await_ready(); // what is returned by the awaited object
-      switch (co_control{ resumer }) { // what was returned by the `Future::on_await` callable
+      switch (co_control{ *resumer }) { // what was returned by the `Future::on_await` callable
         case co_control::resume:
-          if (!is_resuming)
-          {
-            // footgun check
-            throw std::runtime_error(
-              "[Error]@[Coroutine Promise][Transforming Awaiter]: attempting to override-resume a co_awaiting coroutine is dangerous"
-              ", only override-suspend is permitted for co_await operations"
-            );
-          }
+          // footgun check
+          details::expects(
+            [&] { return is_resuming; },
+            "[Error]@[Coroutine Promise][Transforming Awaiter]: attempting to override-resume a co_awaiting coroutine is dangerous"
+            ", only override-suspend is permitted for co_await operations"
+          );
           return true;
           break;
         case co_control::suspend:
@@ -617,7 +971,7 @@ struct transforming_awaiter
       return wrapped.await_ready();
     }
   }
-  auto await_suspend(std::coroutine_handle<> handle)
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle)
   {
       // an await operation is semantically different from a yield operation
       // yielding communicates with the caller of the coroutine
@@ -626,36 +980,53 @@ struct transforming_awaiter
       // and gives it to the awaited object, it is the awaited objects responsibility to resume eventually
       // `std::coroutine_handle`s are cheaply copyable but it is dangerous to double-resume from the raw handle
       // use it once and dispose of it
-      self->deactivate();
-      self->await_value();
-      return wrapped.await_suspend(handle);
+      // a coroutine whose future object was dropped while it ran is not handed to anyone, it ends right here
+      if (!self->await_value())
+      {
+        handle.destroy();
+        return std::noop_coroutine();
+      }
+      // every flavour of `await_suspend` is forwarded as a symmetric transfer
+      // nothing may touch `this` after the wrapped awaiter took the handle, it may already be resumed elsewhere
+      // the handle is passed typed, so an awaiter taking `std::coroutine_handle<Promise>` can reach `basic_promise::wake`
+      auto typed = std::coroutine_handle<basic_promise<Future>>::from_address(handle.address());
+      using suspend_result = decltype(wrapped.await_suspend(typed));
+      if constexpr (std::is_void_v<suspend_result>)
+      {
+        wrapped.await_suspend(typed);
+        return std::noop_coroutine();
+      }
+      else if constexpr (std::is_same_v<suspend_result, bool>)
+      {
+        return wrapped.await_suspend(typed) ? std::noop_coroutine() : handle;
+      }
+      else
+      {
+        return wrapped.await_suspend(typed);
+      }
   }
   decltype(auto) await_resume()
   {
     // this can only be reached by accessing the raw `coroutine_handle`
     // `basic_coroutine::resume` only resumes manually if NOT awaiting a value
-    self->recieve_value();
-    self->activate();
+    // an awaiter that was ready never suspended, so only a suspended coroutine is reactivated
+    if (self->awaiting())
+    {
+      self->activate();
+    }
     if constexpr (has_await_wrapper<Recievable>() && !std::is_same_v<Resumer, co_control>)
     {
-      auto lock = self->lock_future();
-      if (!self->has_future())
-      {
-        throw std::runtime_error(
-          "[Error]@[Coroutine Promise][Transforming Awaiter]: missing future object"
-        );
-      }
-      if constexpr (std::is_invocable_v<decltype(resumer.on_resume), Recievable>)
+      if constexpr (std::is_invocable_v<decltype(resumer->on_resume), Recievable>)
       {
         // this is where magic can happen
         // transforming the value and/or type returned to the coroutine depending on what type was expected
-        return resumer.on_resume(static_cast<Recievable>(wrapped.await_resume()));
+        return resumer->on_resume(static_cast<Recievable>(wrapped.await_resume()));
       }
       else
       {
         // this is a better option
         // just adds side effects to the resume portion of the transaction
-        resumer.on_resume();
+        resumer->on_resume();
         return wrapped.await_resume();
       }
     }
@@ -671,24 +1042,19 @@ template<typename U>
 auto
 await_transform(U&& awaitable) requires GlobalAwaitable<U>
 {
+  BASIC_COROUTINE_TRACE(await, this);
   auto&& awaiter = operator co_await(std::forward<U>(awaitable));
   using Recievable = decltype(awaiter.await_resume());
-  using Awaiter = decltype(awaiter);
+  // an awaiter returned by value is moved into the transforming awaiter, it would dangle once this function returns
+  using Awaiter = decltype(operator co_await(std::forward<U>(awaitable)));
   if constexpr (has_await_wrapper<Recievable>())
   {
-    auto lock = lock_future();
-    if (!has_future())
-    {
-      throw std::runtime_error(
-        "[Error]@[Coroutine Promise][Transforming Awaiter]: missing future object"
-      );
-    }
-    auto resumer = future().on_await(co_expect<Recievable>{});
-    return transforming_awaiter<Recievable, Awaiter, decltype(resumer)>{ this, static_cast<Awaiter>(awaiter), std::move(resumer) };
+    auto resumer = resumer_of([](Future& f) { return f.on_await(co_expect<Recievable>{}); });
+    return transforming_awaiter<Recievable, Awaiter, resumer_type<decltype(resumer)>>{ this, static_cast<Awaiter&&>(awaiter), std::move(resumer) };
   }
   else
   {
-    return transforming_awaiter<Recievable, Awaiter, co_control>{ this, static_cast<Awaiter>(awaiter), co_control::surrender };
+    return transforming_awaiter<Recievable, Awaiter, co_control>{ this, static_cast<Awaiter&&>(awaiter), co_control::surrender };
   }
 }
 
@@ -696,24 +1062,19 @@ template<typename U>
 auto
 await_transform(U&& awaitable) requires LocalAwaitable<U>
 {
+  BASIC_COROUTINE_TRACE(await, this);
   auto&& awaiter = awaitable.operator co_await();
   using Recievable = decltype(awaiter.await_resume());
-  using Awaiter = decltype(awaiter);
+  // an awaiter returned by value is moved into the transforming awaiter, it would dangle once this function returns
+  using Awaiter = decltype(awaitable.operator co_await());
   if constexpr (has_await_wrapper<Recievable>())
   {
-    auto lock = lock_future();
-    if (!has_future())
-    {
-      throw std::runtime_error(
-        "[Error]@[Coroutine Promise][Transforming Awaiter]: missing future object"
-      );
-    }
-    auto resumer = future().on_await(co_expect<Recievable>{});
-    return transforming_awaiter<Recievable, Awaiter, decltype(resumer)>{ this, static_cast<Awaiter>(awaiter), std::move(resumer) };
+    auto resumer = resumer_of([](Future& f) { return f.on_await(co_expect<Recievable>{}); });
+    return transforming_awaiter<Recievable, Awaiter, resumer_type<decltype(resumer)>>{ this, static_cast<Awaiter&&>(awaiter), std::move(resumer) };
   }
   else
   {
-    return transforming_awaiter<Recievable, Awaiter, co_control>{ this, static_cast<Awaiter>(awaiter), co_control::surrender };
+    return transforming_awaiter<Recievable, Awaiter, co_control>{ this, static_cast<Awaiter&&>(awaiter), co_control::surrender };
   }
 }
 
@@ -721,18 +1082,12 @@ template<typename U>
 auto
 await_transform(U&& awaiter) requires BasicAwaiter<U>
 {
+  BASIC_COROUTINE_TRACE(await, this);
   using Recievable = decltype(awaiter.await_resume());
   if constexpr (has_await_wrapper<Recievable>())
   {
-    auto lock = lock_future();
-    if (!has_future())
-    {
-      throw std::runtime_error(
-        "[Error]@[Coroutine Promise][Transforming Awaiter]: missing future object"
-      );
-    }
-    auto resumer = future().on_await(co_expect<Recievable>{});
-    return transforming_awaiter<Recievable, U&&, decltype(resumer)>{ this, std::forward<U>(awaiter), std::move(resumer) };
+    auto resumer = resumer_of([](Future& f) { return f.on_await(co_expect<Recievable>{}); });
+    return transforming_awaiter<Recievable, U&&, resumer_type<decltype(resumer)>>{ this, std::forward<U>(awaiter), std::move(resumer) };
   }
   else
   {
@@ -0,0 +1,405 @@
+#pragma once
+
+#include <waker.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace tmf
+{
+
+// a bounded multi-producer multi-consumer queue between coroutines
+// `co_await ch.send(value)` suspends while the channel is full, `co_await ch.recv()` while it is empty, no thread blocks
+// the fast path is Vyukov's bounded MPMC ring, one CAS per operation
+// parked coroutines wait in FIFO queues taken under a mutex only on the slow path, whoever makes progress possible hands
+// the value over to a parked coroutine directly and wakes it through its `waker`, so a woken coroutine never retries
+template<typename T>
+class channel
+{
+  struct cell
+  {
+    std::atomic<std::size_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T& value() { return *std::launder(reinterpret_cast<T*>(storage)); }
+  };
+
+  struct parked
+  {
+    parked* next{ nullptr };
+    waker wake{};
+  };
+
+  struct wait_queue
+  {
+    std::mutex mutex;
+    parked* head{ nullptr };
+    parked* tail{ nullptr };
+    std::atomic<std::size_t> size{ 0 }; // read without the lock, to skip it when nobody is parked
+
+    void push(parked& node)
+    {
+      node.next = nullptr;
+      (tail ? tail->next : head) = &node;
+      tail = &node;
+    }
+
+    parked* pop()
+    {
+      parked* node = head;
+      if (node && !(head = node->next))
+      {
+        tail = nullptr;
+      }
+      return node;
+    }
+  };
+
+  // wakes a list of parked coroutines, taking each link before the node can disappear with its resumed frame
+  static void wake_all(parked* list)
+  {
+    while (list)
+    {
+      parked* node = std::exchange(list, list->next);
+      node->wake();
+    }
+  }
+
+  std::unique_ptr<cell[]> m_cells;
+  std::size_t m_mask;
+  alignas(64) std::atomic<std::size_t> m_enqueue{ 0 };
+  alignas(64) std::atomic<std::size_t> m_dequeue{ 0 };
+  alignas(64) wait_queue m_senders{};
+  alignas(64) wait_queue m_receivers{};
+  std::atomic<bool> m_closed{ false };
+
+public:
+  class send_awaiter;
+  class recv_awaiter;
+
+private:
+  struct parked_sender : parked
+  {
+    T* value;
+    bool sent{ false };
+  };
+
+  struct parked_receiver : parked
+  {
+    std::optional<T>* value;
+  };
+
+  bool push(T& value)
+  {
+    std::size_t position = m_enqueue.load(std::memory_order_relaxed);
+    while (true)
+    {
+      cell& c = m_cells[position & m_mask];
+      std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+      auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+      if (difference == 0)
+      {
+        if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+          ::new (c.storage) T(std::move(value));
+          c.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (difference < 0)
+      {
+        return false;
+      }
+      else
+      {
+        position = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool pop(std::optional<T>& out)
+  {
+    std::size_t position = m_dequeue.load(std::memory_order_relaxed);
+    while (true)
+    {
+      cell& c = m_cells[position & m_mask];
+      std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+      auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+      if (difference == 0)
+      {
+        if (m_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+          out.emplace(std::move(c.value()));
+          c.value().~T();
+          c.sequence.store(position + m_mask + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (difference < 0)
+      {
+        return false;
+      }
+      else
+      {
+        position = m_dequeue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // moves values of parked senders into the ring while there is room, returns whether any moved
+  bool admit_senders()
+  {
+    parked* woken = nullptr;
+    parked** woken_tail = &woken;
+    {
+      std::scoped_lock lock{ m_senders.mutex };
+      while (auto* sender = static_cast<parked_sender*>(m_senders.head))
+      {
+        if (!push(*sender->value))
+        {
+          break;
+        }
+        m_senders.pop();
+        m_senders.size.fetch_sub(1, std::memory_order_relaxed);
+        sender->sent = true;
+        *woken_tail = sender;
+        woken_tail = &sender->next;
+      }
+      *woken_tail = nullptr;
+    }
+    wake_all(woken);
+    return woken != nullptr;
+  }
+
+  // hands values from the ring to parked receivers, returns whether any was delivered
+  bool deliver_receivers()
+  {
+    parked* woken = nullptr;
+    parked** woken_tail = &woken;
+    {
+      std::scoped_lock lock{ m_receivers.mutex };
+      while (auto* receiver = static_cast<parked_receiver*>(m_receivers.head))
+      {
+        if (!pop(*receiver->value))
+        {
+          break;
+        }
+        m_receivers.pop();
+        m_receivers.size.fetch_sub(1, std::memory_order_relaxed);
+        *woken_tail = receiver;
+        woken_tail = &receiver->next;
+      }
+      *woken_tail = nullptr;
+    }
+    wake_all(woken);
+    return woken != nullptr;
+  }
+
+  // called after every push and pop, the fence pairs with the one in `park` so either side sees the other
+  void balance()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool moved = true;
+    while (moved)
+    {
+      moved = false;
+      if (m_senders.size.load(std::memory_order_relaxed))
+      {
+        moved |= admit_senders();
+      }
+      if (m_receivers.size.load(std::memory_order_relaxed))
+      {
+        moved |= deliver_receivers();
+      }
+    }
+  }
+
+  // parks `node` unless `attempt` succeeds once registered, returns whether the coroutine has to suspend
+  template<typename Attempt>
+  bool park(wait_queue& queue, parked& node, Attempt&& attempt)
+  {
+    {
+      std::scoped_lock lock{ queue.mutex };
+      queue.size.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!attempt())
+      {
+        queue.push(node);
+        return true;
+      }
+      queue.size.fetch_sub(1, std::memory_order_relaxed);
+    }
+    balance();
+    return false;
+  }
+
+  // wakes every parked coroutine, senders report failure and receivers get nothing
+  void drain_waiters()
+  {
+    parked* senders = nullptr;
+    parked* receivers = nullptr;
+    {
+      std::scoped_lock lock{ m_senders.mutex, m_receivers.mutex };
+      senders = std::exchange(m_senders.head, nullptr);
+      m_senders.tail = nullptr;
+      m_senders.size.store(0, std::memory_order_relaxed);
+      receivers = std::exchange(m_receivers.head, nullptr);
+      m_receivers.tail = nullptr;
+      m_receivers.size.store(0, std::memory_order_relaxed);
+    }
+    wake_all(senders);
+    wake_all(receivers);
+  }
+
+public:
+  // `capacity` is rounded up to a power of two, at least 2
+  explicit channel(std::size_t capacity)
+    : m_cells{ new cell[std::bit_ceil(std::max<std::size_t>(capacity, 2))] }
+    , m_mask{ std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1 }
+  {
+    for (std::size_t i = 0; i <= m_mask; ++i)
+    {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  channel(channel const&) = delete;
+  void operator=(channel const&) = delete;
+
+  // values still queued are destroyed, no coroutine may be parked on the channel anymore
+  ~channel()
+  {
+    std::optional<T> discarded;
+    while (pop(discarded))
+    {
+    }
+  }
+
+  std::size_t capacity() const { return m_mask + 1; }
+
+  bool closed() const { return m_closed.load(std::memory_order_acquire); }
+
+  // no value is accepted afterwards, parked senders fail and receivers drain what is left, then get nothing
+  void close()
+  {
+    m_closed.store(true, std::memory_order_seq_cst);
+    balance();
+    drain_waiters();
+  }
+
+  // the non-suspending operations, `value` is only moved from on success
+  bool try_send(T& value)
+  {
+    if (closed() || !push(value))
+    {
+      return false;
+    }
+    balance();
+    return true;
+  }
+
+  bool try_send(T&& value) { return try_send(value); }
+
+  std::optional<T> try_recv()
+  {
+    std::optional<T> value;
+    if (pop(value))
+    {
+      balance();
+    }
+    return value;
+  }
+
+  // `co_await` yields whether the value was sent, false once the channel is closed
+  class send_awaiter
+  {
+    channel* m_channel;
+    parked_sender m_node;
+    T m_value;
+
+  public:
+    send_awaiter(channel& ch, T value)
+      : m_channel{ &ch }
+      , m_value{ std::move(value) }
+    {
+      m_node.value = &m_value;
+    }
+
+    send_awaiter(send_awaiter const&) = delete;
+    void operator=(send_awaiter const&) = delete;
+
+    bool await_ready()
+    {
+      if (m_channel->closed())
+      {
+        return true;
+      }
+      m_node.sent = m_channel->try_send(m_value);
+      return m_node.sent;
+    }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+      m_node.wake = waker::of(handle);
+      return m_channel->park(m_channel->m_senders, m_node, [this]() {
+        if (m_channel->closed())
+        {
+          return true;
+        }
+        return m_node.sent = m_channel->push(m_value);
+      });
+    }
+
+    bool await_resume() { return m_node.sent; }
+  };
+
+  // `co_await` yields the next value, nothing once the channel is closed and empty
+  class recv_awaiter
+  {
+    channel* m_channel;
+    parked_receiver m_node;
+    std::optional<T> m_value{};
+
+  public:
+    explicit recv_awaiter(channel& ch)
+      : m_channel{ &ch }
+    {
+      m_node.value = &m_value;
+    }
+
+    recv_awaiter(recv_awaiter const&) = delete;
+    void operator=(recv_awaiter const&) = delete;
+
+    bool await_ready()
+    {
+      m_value = m_channel->try_recv();
+      return m_value || m_channel->closed();
+    }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+      m_node.wake = waker::of(handle);
+      return m_channel->park(m_channel->m_receivers, m_node, [this]() {
+        return m_channel->pop(m_value) || m_channel->closed();
+      });
+    }
+
+    std::optional<T> await_resume() { return std::move(m_value); }
+  };
+
+  send_awaiter send(T value) { return { *this, std::move(value) }; }
+
+  recv_awaiter recv() { return recv_awaiter{ *this }; }
+};
+
+} // end namespace tmf
@@ -0,0 +1,346 @@
+#pragma once
+
+#include <contract.hpp>
+#include <continuation.hpp>
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tmf
+{
+
+// a future that can be driven through `resume_with`, every `basic_coroutine` is one
+template<typename F>
+concept Continuable = requires(F& f, continuation then)
+{
+  { f.resume_with(then) } -> std::same_as<std::coroutine_handle<>>;
+  { f.resumable() } -> std::convertible_to<bool>;
+  { f.done() } -> std::convertible_to<bool>;
+};
+
+namespace details
+{
+
+// one child of a combinator, type erased so children of different types share a single array
+// it is also the continuation the child hands control to, `resume` is set by the combinator when it starts the child
+struct child_record : continuation::node
+{
+  void* future;
+  std::coroutine_handle<> (*step)(void* future, continuation then);
+  bool (*busy)(void* future); // neither finished nor suspended, nothing can be attached to it
+  void* state{ nullptr };
+
+  // runs the child until its next yield or return, a null handle when it cannot be resumed any more
+  template<Continuable F>
+  static std::coroutine_handle<> step_of(void* future, continuation then)
+  {
+    auto& f = *static_cast<F*>(future);
+    return f.resumable() ? f.resume_with(then) : std::coroutine_handle<>{};
+  }
+
+  template<Continuable F>
+  static bool busy_of(void* future)
+  {
+    auto& f = *static_cast<F*>(future);
+    return !f.done() && !f.resumable();
+  }
+
+  template<typename F>
+  static child_record of(F& future)
+  {
+    return { {}, std::addressof(future), &step_of<F>, &busy_of<F> };
+  }
+};
+
+inline void require_startable(std::span<child_record const> children)
+{
+  for (auto const& child : children)
+  {
+    details::expects(
+      [&] { return !child.busy(child.future); },
+      "[Error]@[Combinator]: a child is already running, scheduled or awaiting, it can only be waited on while suspended"
+    );
+  }
+}
+
+// counts the children still running plus one held by the parent until it suspended
+// whoever takes the count to zero resumes the parent, so it is resumed exactly once and never before it suspended
+struct all_state
+{
+  std::atomic<std::size_t> pending{ 0 };
+  continuation parent{};
+
+  std::coroutine_handle<> arrive()
+  {
+    return pending.fetch_sub(1, std::memory_order_acq_rel) == 1 ? parent() : std::noop_coroutine();
+  }
+
+  // the continuation of every child, it drives the child through its yields until it returns
+  static std::coroutine_handle<> on_event(continuation::node& event)
+  {
+    auto& child = static_cast<child_record&>(event);
+    if (auto next = child.step(child.future, child))
+    {
+      return next;
+    }
+    return static_cast<all_state*>(child.state)->arrive();
+  }
+
+  // a child destroyed before it returned, abandoned in a `co_await`, still arrives, the parent is not left waiting for it
+  static void on_drop(continuation::node& event)
+  {
+    static_cast<all_state*>(static_cast<child_record&>(event).state)->arrive().resume();
+  }
+
+  // starts every child on the parent's thread, returns whether the parent has to suspend
+  bool start(continuation awaiting, std::span<child_record> children)
+  {
+    parent = awaiting;
+    pending.store(children.size() + 1, std::memory_order_relaxed);
+    for (auto& child : children)
+    {
+      child.state = this;
+      child.resume = on_event;
+      child.drop = on_drop;
+      if (auto next = child.step(child.future, child))
+      {
+        next.resume();
+      }
+      else
+      {
+        arrive();
+      }
+    }
+    return pending.fetch_sub(1, std::memory_order_acq_rel) != 1;
+  }
+};
+
+// shared with children that may outlive the `co_await`, so it is a single heap block with the records trailing it
+// `refs` counts the children still holding a continuation plus the awaiter, the last one frees the block
+struct any_state
+{
+  static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+  std::atomic<std::size_t> refs;
+  std::atomic<std::size_t> winner{ none };
+  std::atomic<int> wake{ 2 }; // the first finisher and the parent leaving `await_suspend`, the second of them resumes it
+  continuation parent{};
+  std::size_t count;
+
+  explicit any_state(std::size_t children)
+    : refs{ children + 1 }
+    , count{ children }
+  {
+  }
+
+  child_record* records() { return reinterpret_cast<child_record*>(this + 1); }
+
+  static any_state* create(std::size_t children)
+  {
+    static_assert(alignof(child_record) <= alignof(any_state));
+    void* block = ::operator new(sizeof(any_state) + children * sizeof(child_record));
+    return ::new (block) any_state{ children };
+  }
+
+  void release()
+  {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      this->~any_state();
+      ::operator delete(this);
+    }
+  }
+
+  std::coroutine_handle<> finish(std::size_t index)
+  {
+    std::size_t expected = none;
+    std::coroutine_handle<> next = std::noop_coroutine();
+    if (winner.compare_exchange_strong(expected, index, std::memory_order_acq_rel) &&
+        wake.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      next = parent();
+    }
+    release();
+    return next;
+  }
+
+  static std::coroutine_handle<> on_event(continuation::node& event)
+  {
+    auto& child = static_cast<child_record&>(event);
+    auto& self = *static_cast<any_state*>(child.state);
+    // once decided the parent may already be done with its futures, a loser is not touched again
+    if (self.winner.load(std::memory_order_acquire) == none)
+    {
+      if (auto next = child.step(child.future, child))
+      {
+        return next;
+      }
+    }
+    return self.finish(static_cast<std::size_t>(&child - self.records()));
+  }
+
+  // a child destroyed before it returned never runs `on_event` again, it lets go of the block here, the parent counts it as
+  // finished should nothing have won yet rather than waiting for it forever
+  static void on_drop(continuation::node& event)
+  {
+    auto& child = static_cast<child_record&>(event);
+    auto& self = *static_cast<any_state*>(child.state);
+    self.finish(static_cast<std::size_t>(&child - self.records())).resume();
+  }
+
+  bool start(continuation awaiting)
+  {
+    parent = awaiting;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      child_record& child = records()[i];
+      child.state = this;
+      child.resume = on_event;
+      child.drop = on_drop;
+      std::coroutine_handle<> next{};
+      if (winner.load(std::memory_order_acquire) == none)
+      {
+        next = child.step(child.future, child);
+      }
+      if (next)
+      {
+        next.resume();
+      }
+      else
+      {
+        // the parent cannot be resumed from here, it still holds `wake`
+        finish(i);
+      }
+    }
+    return wake.fetch_sub(1, std::memory_order_acq_rel) != 1;
+  }
+};
+
+} // end namespace details
+
+// resumes the awaiting coroutine once every child has returned
+// children are run on the awaiting thread through `resume_with`, each one until it yields or returns, a child that yields is
+// resumed again right away, a child that awaits continues from wherever its awaited object resumes it
+// nothing is allocated besides the record array of the range overload
+template<typename Records>
+class when_all_awaiter
+{
+  details::all_state m_state{};
+  Records m_children;
+  parked_coroutine m_parent{};
+
+public:
+  explicit when_all_awaiter(Records children)
+    : m_children{ std::move(children) }
+  {
+  }
+
+  when_all_awaiter(when_all_awaiter const&) = delete;
+  void operator=(when_all_awaiter const&) = delete;
+
+  bool await_ready() { return std::ranges::empty(m_children); }
+
+  template<typename Promise>
+  bool await_suspend(std::coroutine_handle<Promise> awaiting)
+  {
+    details::require_startable(m_children);
+    m_parent.park(awaiting);
+    return m_state.start(m_parent.then(), m_children);
+  }
+
+  void await_resume() {}
+};
+
+// resumes the awaiting coroutine once the first child returned, `co_await` yields its index
+// the other children keep their continuation, each stops being driven at its next yield or return
+// the state shared with them is the one allocation, freed by whichever of them lets go last
+class when_any_awaiter
+{
+  details::any_state* m_state;
+  parked_coroutine m_parent{};
+
+public:
+  explicit when_any_awaiter(details::any_state* state)
+    : m_state{ state }
+  {
+  }
+
+  when_any_awaiter(when_any_awaiter const&) = delete;
+  void operator=(when_any_awaiter const&) = delete;
+
+  ~when_any_awaiter() { m_state->release(); }
+
+  bool await_ready() { return m_state->count == 0; }
+
+  template<typename Promise>
+  bool await_suspend(std::coroutine_handle<Promise> awaiting)
+  {
+    details::require_startable({ m_state->records(), m_state->count });
+    m_parent.park(awaiting);
+    return m_state->start(m_parent.then());
+  }
+
+  std::size_t await_resume() { return m_state->winner.load(std::memory_order_acquire); }
+};
+
+// futures are referenced, not owned, temporaries live until the end of the `co_await` expression
+template<typename... Futures>
+requires (... && Continuable<std::remove_reference_t<Futures>>)
+auto when_all(Futures&&... futures)
+{
+  using records = std::array<details::child_record, sizeof...(Futures)>;
+  return when_all_awaiter<records>{ records{ details::child_record::of(futures)... } };
+}
+
+template<std::ranges::range Range>
+requires Continuable<std::ranges::range_value_t<Range>>
+auto when_all(Range& futures)
+{
+  std::vector<details::child_record> records;
+  if constexpr (std::ranges::sized_range<Range>)
+  {
+    records.reserve(std::ranges::size(futures));
+  }
+  for (auto& future : futures)
+  {
+    records.push_back(details::child_record::of(future));
+  }
+  return when_all_awaiter<std::vector<details::child_record>>{ std::move(records) };
+}
+
+template<typename... Futures>
+requires (... && Continuable<std::remove_reference_t<Futures>>)
+auto when_any(Futures&&... futures)
+{
+  auto* state = details::any_state::create(sizeof...(Futures));
+  std::size_t i = 0;
+  (..., ::new (state->records() + i++) details::child_record{ details::child_record::of(futures) });
+  return when_any_awaiter{ state };
+}
+
+// the range is walked twice, once to size the shared block and once to fill it
+template<std::ranges::forward_range Range>
+requires Continuable<std::ranges::range_value_t<Range>>
+auto when_any(Range& futures)
+{
+  std::size_t count = static_cast<std::size_t>(std::ranges::distance(futures));
+  auto* state = details::any_state::create(count);
+  std::size_t i = 0;
+  for (auto& future : futures)
+  {
+    ::new (state->records() + i++) details::child_record{ details::child_record::of(future) };
+  }
+  return when_any_awaiter{ state };
+}
+
+} // end namespace tmf
@@ -58,4 +58,12 @@ concept VoidReturningFuture = requires(T& f)
   f.on_return();
 };
 
+// a future which never leaves the thread it was created on, declared with
+// `static constexpr bool single_threaded = true;`
+template<typename T>
+concept SingleThreadedFuture = requires
+{
+  requires T::single_threaded;
+};
+
 }
\ No newline at end of file
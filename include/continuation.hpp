@@ -0,0 +1,114 @@
+#pragma once
+
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+
+namespace tmf
+{
+
+// what runs once a coroutine hands control back, at its next yield or when it returns
+// it is a single word, the address of the coroutine to continue with or of a `node` for anything else, so it costs the promise
+// no more than a handle and registering one never allocates
+// resuming returns the coroutine to transfer execution to, which keeps chains of any depth in constant stack
+class continuation
+{
+public:
+  // something to continue with that is not a coroutine, or needs more than its handle, kept by whoever registers it
+  // `resume` is passed the node itself, a derived type reaches its own state from there, the node must stay put until it ran
+  // `drop`, when set, is called instead if the coroutine it was registered with is destroyed before reaching it
+  struct node
+  {
+    std::coroutine_handle<> (*resume)(node& self){ nullptr };
+    void (*drop)(node& self){ nullptr };
+  };
+
+private:
+  // a node address is tagged in its lowest bit, a coroutine frame and a node are both at least pointer aligned
+  static constexpr std::uintptr_t node_tag = 1;
+
+  std::uintptr_t m_target{ 0 };
+
+public:
+  continuation() = default;
+  continuation(node& next)
+    : m_target{ reinterpret_cast<std::uintptr_t>(&next) | node_tag }
+  {
+  }
+
+  // continue with `awaiting` itself
+  static continuation of(std::coroutine_handle<> awaiting)
+  {
+    continuation then{};
+    then.m_target = reinterpret_cast<std::uintptr_t>(awaiting.address());
+    return then;
+  }
+
+  explicit operator bool() const { return m_target != 0; }
+
+  // the coroutine to transfer execution to, `std::noop_coroutine()` when there is none
+  std::coroutine_handle<> operator()() const
+  {
+    if (m_target & node_tag)
+    {
+      auto& next = *reinterpret_cast<node*>(m_target & ~node_tag);
+      return next.resume(next);
+    }
+    if (m_target)
+    {
+      return std::coroutine_handle<>::from_address(reinterpret_cast<void*>(m_target));
+    }
+    return std::noop_coroutine();
+  }
+
+  // lets go of a continuation that will never run, only a node with a `drop` has anything to release
+  void discard() const
+  {
+    if (m_target & node_tag)
+    {
+      auto& next = *reinterpret_cast<node*>(m_target & ~node_tag);
+      if (next.drop)
+      {
+        next.drop(next);
+      }
+    }
+  }
+};
+
+// a coroutine parked in a `co_await`, kept by its awaiter until whatever it waits for resumes it
+// a promise with an `unpark()` member, as `basic_promise` has, is resumed through it, so a coroutine whose future object was
+// dropped meanwhile is destroyed instead of resumed, any other coroutine is resumed as is
+class parked_coroutine : continuation::node
+{
+  void* m_address{ nullptr };
+
+  template<typename Promise>
+  static std::coroutine_handle<> unpark(node& self)
+  {
+    auto address = static_cast<parked_coroutine&>(self).m_address;
+    if constexpr (requires(Promise& p) { { p.unpark() } -> std::same_as<std::coroutine_handle<>>; })
+    {
+      return std::coroutine_handle<Promise>::from_address(address).promise().unpark();
+    }
+    else
+    {
+      return std::coroutine_handle<>::from_address(address);
+    }
+  }
+
+public:
+  template<typename Promise>
+  void park(std::coroutine_handle<Promise> awaiting)
+  {
+    m_address = awaiting.address();
+    resume = &unpark<Promise>;
+  }
+
+  // continues with the parked coroutine, this object has to stay put until then
+  continuation then() { return continuation{ *this }; }
+
+  // the coroutine to transfer to, or to `resume()`, `std::noop_coroutine()` once it was destroyed instead
+  std::coroutine_handle<> operator()() { return resume(*this); }
+};
+
+} // end namespace tmf
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+// what happens when a coroutine is misused, resumed twice at once for instance, chosen by defining `BASIC_COROUTINE_CONTRACT`
+// - `BASIC_COROUTINE_CONTRACT_THROW`: a `std::runtime_error` is thrown, the default when exceptions are enabled
+// - `BASIC_COROUTINE_CONTRACT_TERMINATE`: the message goes to stderr and the program aborts, the default without exceptions
+// - `BASIC_COROUTINE_CONTRACT_UNCHECKED`: nothing is checked, misuse is undefined behaviour
+// whatever the mode, a violation is reported out of line, so the inlined yield and resume paths carry no message and no
+// exception construction, only a branch that is never taken, which the unchecked mode removes as well
+#define BASIC_COROUTINE_CONTRACT_THROW 1
+#define BASIC_COROUTINE_CONTRACT_TERMINATE 2
+#define BASIC_COROUTINE_CONTRACT_UNCHECKED 3
+
+#ifndef BASIC_COROUTINE_CONTRACT
+#ifdef __cpp_exceptions
+#define BASIC_COROUTINE_CONTRACT BASIC_COROUTINE_CONTRACT_THROW
+#else
+#define BASIC_COROUTINE_CONTRACT BASIC_COROUTINE_CONTRACT_TERMINATE
+#endif
+#endif
+
+#if BASIC_COROUTINE_CONTRACT == BASIC_COROUTINE_CONTRACT_THROW && !defined(__cpp_exceptions)
+#error "BASIC_COROUTINE_CONTRACT_THROW requires exceptions, pick BASIC_COROUTINE_CONTRACT_TERMINATE or _UNCHECKED"
+#endif
+
+namespace tmf
+{
+
+enum class contract_policy
+{
+  throw_exception,
+  terminate,
+  unchecked,
+};
+
+#if BASIC_COROUTINE_CONTRACT == BASIC_COROUTINE_CONTRACT_THROW
+inline constexpr contract_policy contract = contract_policy::throw_exception;
+#elif BASIC_COROUTINE_CONTRACT == BASIC_COROUTINE_CONTRACT_TERMINATE
+inline constexpr contract_policy contract = contract_policy::terminate;
+#else
+inline constexpr contract_policy contract = contract_policy::unchecked;
+#endif
+
+// whether a broken contract may throw, for `noexcept` specifications
+inline constexpr bool contract_throws = contract == contract_policy::throw_exception;
+
+// the namespace is inline wherever it is opened first, see `details.hpp`, this header may well come before it
+inline namespace details
+{
+
+[[noreturn, gnu::cold, gnu::noinline]] inline void contract_violation(char const* message) noexcept(!contract_throws)
+{
+#if BASIC_COROUTINE_CONTRACT == BASIC_COROUTINE_CONTRACT_THROW
+  throw std::runtime_error(message);
+#else
+  std::fprintf(stderr, "%s\n", message);
+  std::abort();
+#endif
+}
+
+// `holds()` must return true, it is not even called in the unchecked mode
+template<typename Condition>
+void expects(Condition&& holds, char const* message) noexcept(!contract_throws)
+{
+  if constexpr (contract != contract_policy::unchecked)
+  {
+    if (!holds()) [[unlikely]]
+    {
+      contract_violation(message);
+    }
+  }
+}
+
+} // end namespace details
+
+} // end namespace tmf
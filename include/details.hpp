@@ -2,7 +2,9 @@
 
 #include <concepts.hpp>
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
 
 namespace tmf::inline details
@@ -38,6 +40,43 @@ struct unknown
   operator T() const;
 };
 
+// a word of flags, atomic when shared between threads and a plain integer otherwise
+template<bool Shared>
+struct state_word;
+
+template<>
+struct state_word<true>
+{
+  std::atomic<std::uint32_t> bits{ 0 };
+
+  std::uint32_t load() const { return bits.load(std::memory_order_acquire); }
+  void store(std::uint32_t value) { bits.store(value, std::memory_order_release); }
+  std::uint32_t set(std::uint32_t mask) { return bits.fetch_or(mask, std::memory_order_acq_rel); }
+  std::uint32_t clear(std::uint32_t mask) { return bits.fetch_and(~mask, std::memory_order_acq_rel); }
+  // sets the flags of `set_mask` and clears those of `clear_mask` in a single `lock xadd`, returns the previous state
+  // the caller knows the flags of `set_mask` are clear and those of `clear_mask` are set, so adding the difference flips
+  // exactly them, whatever other flags change concurrently
+  std::uint32_t transition(std::uint32_t set_mask, std::uint32_t clear_mask)
+  {
+    return bits.fetch_add(set_mask - clear_mask, std::memory_order_acq_rel);
+  }
+};
+
+template<>
+struct state_word<false>
+{
+  std::uint32_t bits{ 0 };
+
+  std::uint32_t load() const { return bits; }
+  void store(std::uint32_t value) { bits = value; }
+  std::uint32_t set(std::uint32_t mask) { return std::exchange(bits, bits | mask); }
+  std::uint32_t clear(std::uint32_t mask) { return std::exchange(bits, bits & ~mask); }
+  std::uint32_t transition(std::uint32_t set_mask, std::uint32_t clear_mask)
+  {
+    return std::exchange(bits, (bits | set_mask) & ~clear_mask);
+  }
+};
+
 #ifdef BASIC_COROUTINE_INTERFACE_CONSTRAINTS
 
 // clang-format off
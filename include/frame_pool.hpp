@@ -0,0 +1,176 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace tmf
+{
+
+// counters describing how coroutine frames were obtained on the calling thread
+struct frame_allocation_stats
+{
+  std::size_t allocations{ 0 };            // frames handed out to coroutines
+  std::size_t deallocations{ 0 };          // frames given back by coroutines
+  std::size_t upstream_allocations{ 0 };   // requests that reached global `operator new`
+  std::size_t upstream_deallocations{ 0 }; // blocks returned to global `operator delete`
+};
+
+inline namespace details
+{
+
+// a thread-local free-list allocator with fixed size classes
+// frames may be released on a different thread than the one they were allocated on,
+// the block simply joins the free-list of the releasing thread
+class frame_pool
+{
+public:
+  static constexpr std::size_t granularity = 64;
+  static constexpr std::size_t class_count = 64;
+  static constexpr std::size_t max_pooled_size = granularity * class_count;
+  static constexpr std::size_t max_cached_per_class = 1024;
+
+private:
+  struct free_block
+  {
+    free_block* next;
+  };
+
+  struct size_class
+  {
+    free_block* head{ nullptr };
+    std::size_t cached{ 0 };
+  };
+
+  std::array<size_class, class_count> m_classes{};
+  frame_allocation_stats m_stats{};
+
+  // trivially destructible, so it stays readable while thread-local destructors run
+  static bool& alive()
+  {
+    static thread_local bool flag{ false };
+    return flag;
+  }
+
+  static constexpr std::size_t class_of(std::size_t size)
+  {
+    return (size - 1) / granularity;
+  }
+
+public:
+  static constexpr bool poolable(std::size_t size)
+  {
+    return size != 0 && size <= max_pooled_size;
+  }
+
+  // what a frame of `size` bytes really occupies, a block freed into a size class must fit any request of that class,
+  // whichever thread and pool the frame was allocated from
+  static constexpr std::size_t block_size(std::size_t size)
+  {
+    return poolable(size) ? (class_of(size) + 1) * granularity : size;
+  }
+
+private:
+  frame_pool() { alive() = true; }
+
+public:
+  frame_pool(frame_pool const&) = delete;
+  void operator=(frame_pool const&) = delete;
+
+  ~frame_pool()
+  {
+    alive() = false;
+    for (auto& sc : m_classes)
+    {
+      while (sc.head)
+      {
+        ::operator delete(std::exchange(sc.head, sc.head->next));
+      }
+      sc.cached = 0;
+    }
+  }
+
+  // returns nullptr once the calling thread has begun tearing down its pool
+  static frame_pool* local()
+  {
+    static thread_local frame_pool pool;
+    return alive() ? &pool : nullptr;
+  }
+
+  void* allocate(std::size_t size)
+  {
+    ++m_stats.allocations;
+    if (!poolable(size))
+    {
+      ++m_stats.upstream_allocations;
+      return ::operator new(size);
+    }
+    auto& sc = m_classes[class_of(size)];
+    if (sc.head)
+    {
+      --sc.cached;
+      return std::exchange(sc.head, sc.head->next);
+    }
+    ++m_stats.upstream_allocations;
+    return ::operator new(block_size(size));
+  }
+
+  void deallocate(void* ptr, std::size_t size) noexcept
+  {
+    ++m_stats.deallocations;
+    if (!poolable(size))
+    {
+      ++m_stats.upstream_deallocations;
+      ::operator delete(ptr);
+      return;
+    }
+    auto& sc = m_classes[class_of(size)];
+    if (sc.cached == max_cached_per_class)
+    {
+      ++m_stats.upstream_deallocations;
+      ::operator delete(ptr);
+      return;
+    }
+    ++sc.cached;
+    sc.head = ::new (ptr) free_block{ sc.head };
+  }
+
+  frame_allocation_stats const& stats() const { return m_stats; }
+};
+
+// called by `basic_promise::operator new` when `Future` does not supply its own allocator
+inline void* allocate_pooled_frame(std::size_t size)
+{
+  if (auto pool = frame_pool::local())
+  {
+    return pool->allocate(size);
+  }
+  // rounded up like a pooled block, it may still be cached by a thread whose pool is alive once released
+  return ::operator new(frame_pool::block_size(size));
+}
+
+inline void deallocate_pooled_frame(void* ptr, std::size_t size) noexcept
+{
+  if (auto pool = frame_pool::local())
+  {
+    pool->deallocate(ptr, size);
+    return;
+  }
+  ::operator delete(ptr);
+}
+
+} // end namespace details
+
+// snapshot of the calling thread's pooled frame allocations
+// in a steady state workload `upstream_allocations` stops growing
+inline frame_allocation_stats frame_allocations()
+{
+  if (auto pool = details::frame_pool::local())
+  {
+    return pool->stats();
+  }
+  return {};
+}
+
+} // end namespace tmf
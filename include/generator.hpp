@@ -0,0 +1,127 @@
+#pragma once
+
+#include <basic_coroutine.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace tmf
+{
+
+// a lazy `std::ranges::input_range` of the values yielded by a coroutine
+// nothing is copied or buffered, dereferencing reads the yielded object where it lives inside the suspended frame
+// only values of exactly `T` may be yielded, a converted temporary would not outlive the suspension
+// `co_yield tmf::bulk(span)` hands over a whole batch in one suspension, the iterator walks it before resuming again
+// a default constructed or moved from generator is an empty range
+template<typename T>
+class generator
+  : public basic_coroutine<generator<T>>
+  , public std::ranges::view_interface<generator<T>>
+{
+  static_assert(std::is_object_v<T>, "generator<T> yields objects, not references");
+
+  T const* m_current{ nullptr };
+  T const* m_batch_end{ nullptr };
+  std::exception_ptr m_exception{};
+
+  void advance()
+  {
+    if (m_current != m_batch_end && ++m_current != m_batch_end)
+    {
+      return;
+    }
+    if (this->resume() && m_exception)
+    {
+      std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+  }
+
+public:
+  static constexpr bool single_threaded = true;
+
+  class iterator
+  {
+    generator* m_generator{ nullptr };
+
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = T const&;
+
+    iterator() = default;
+    explicit iterator(generator& g) : m_generator{ std::addressof(g) } {}
+
+    reference operator*() const { return *m_generator->m_current; }
+    T const* operator->() const { return m_generator->m_current; }
+
+    iterator& operator++()
+    {
+      m_generator->advance();
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(iterator const& it, std::default_sentinel_t) { return it.m_generator->done(); }
+  };
+
+  generator() = default;
+  generator(generator&&) = default;
+  generator& operator=(generator&&) = default;
+
+  ///! <customization points>
+
+  auto on_invoke()
+  {
+    return co_control::suspend;
+  }
+
+  void on_return()
+  {
+  }
+
+  template<typename U>
+  co_control on_yield(U&& value) requires std::is_same_v<std::remove_cvref_t<U>, std::remove_cv_t<T>>
+  {
+    m_current = std::addressof(value);
+    m_batch_end = m_current + 1;
+    return co_control::suspend;
+  }
+
+  co_control on_yield(std::span<const std::remove_cv_t<T>> batch)
+  {
+    m_current = batch.data();
+    m_batch_end = batch.data() + batch.size();
+    // an empty batch has nothing to look at, keep running
+    return batch.empty() ? co_control::resume : co_control::suspend;
+  }
+
+  void on_error(std::exception_ptr e)
+  {
+    m_exception = e;
+  }
+
+  ///! </customization points>
+
+  // runs the coroutine up to its first yield, call once
+  iterator begin()
+  {
+    advance();
+    return iterator{ *this };
+  }
+
+  std::default_sentinel_t end() const { return std::default_sentinel; }
+
+  // the rest of the batch the current value belongs to, for consumers that process whole batches
+  std::span<T const> batch() const { return { m_current, m_batch_end }; }
+
+  // skips the rest of the current batch, as if every element of `batch()` had been iterated
+  void consume_batch() { m_current = m_batch_end; advance(); }
+};
+
+} // end namespace tmf
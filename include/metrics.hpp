@@ -0,0 +1,371 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// aggregate runtime metrics of every `basic_promise`, collected only when `BASIC_COROUTINE_METRICS` is defined
+// - how long a coroutine waited between being handed to its executor and running
+// - how long it ran each time it was resumed
+// - why `basic_coroutine::resume` refused to resume it
+// - how many frames are alive
+// each thread records into its own counters and histograms, which only it writes, so recording takes no lock and no atomic
+// read-modify-write, `metrics::snapshot` reads and merges all of them
+// without the macro the hooks in `basic_promise` are empty inline functions and the per-promise clock takes no space
+
+#ifdef BASIC_COROUTINE_METRICS
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#endif
+
+namespace tmf::metrics
+{
+
+#ifdef BASIC_COROUTINE_METRICS
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+// why `basic_coroutine::resume` returned false
+enum class rejection : std::uint8_t
+{
+  done,
+  active,
+  awaiting,
+  scheduled,
+};
+
+inline constexpr std::size_t rejection_count = 4;
+
+// a log-linear histogram in the manner of HdrHistogram
+// values below 8 have a bucket each, every power of two above is split into 8 buckets, so any value is reported within 12.5%
+// merging two histograms adds up their buckets
+class histogram_snapshot
+{
+public:
+  static constexpr unsigned sub_bits = 3;
+  static constexpr std::uint64_t sub_buckets = std::uint64_t{ 1 } << sub_bits;
+  static constexpr std::size_t bucket_count = (64 - sub_bits + 1) * sub_buckets;
+
+  static constexpr std::size_t bucket_of(std::uint64_t value)
+  {
+    if (value < sub_buckets)
+    {
+      return static_cast<std::size_t>(value);
+    }
+    unsigned const shift = static_cast<unsigned>(std::bit_width(value)) - 1 - sub_bits;
+    return (shift + 1) * sub_buckets + ((value >> shift) & (sub_buckets - 1));
+  }
+
+  // the smallest value falling into `bucket`
+  static constexpr std::uint64_t lowest_of(std::size_t bucket)
+  {
+    if (bucket < sub_buckets)
+    {
+      return bucket;
+    }
+    unsigned const shift = static_cast<unsigned>(bucket / sub_buckets) - 1;
+    return (sub_buckets + bucket % sub_buckets) << shift;
+  }
+
+  // the largest value falling into `bucket`
+  static constexpr std::uint64_t highest_of(std::size_t bucket)
+  {
+    return bucket + 1 < bucket_count ? lowest_of(bucket + 1) - 1 : ~std::uint64_t{ 0 };
+  }
+
+  std::array<std::uint64_t, bucket_count> buckets{};
+  std::uint64_t count{ 0 };
+  std::uint64_t sum{ 0 };
+  std::uint64_t max{ 0 };
+
+  histogram_snapshot& merge(histogram_snapshot const& other)
+  {
+    for (std::size_t i = 0; i < bucket_count; ++i)
+    {
+      buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    max = std::max(max, other.max);
+    return *this;
+  }
+
+  double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+
+  // an upper bound of the value below which a `fraction` of the recorded values fall, `percentile(0.99)` is the p99
+  std::uint64_t percentile(double fraction) const
+  {
+    if (count == 0)
+    {
+      return 0;
+    }
+    auto const rank = static_cast<std::uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i)
+    {
+      seen += buckets[i];
+      if (seen >= std::max<std::uint64_t>(rank, 1))
+      {
+        return std::min(highest_of(i), max);
+      }
+    }
+    return max;
+  }
+};
+
+// every duration is in nanoseconds
+struct report
+{
+  histogram_snapshot schedule_to_resume; // from the call to `executor` until the coroutine runs
+  histogram_snapshot active;             // from a resume until the next suspension
+  std::array<std::uint64_t, rejection_count> rejected{};
+  std::uint64_t frames_created{ 0 };
+  std::uint64_t frames_destroyed{ 0 };
+
+  std::uint64_t rejected_for(rejection reason) const { return rejected[static_cast<std::size_t>(reason)]; }
+
+  // frames may be released on another thread than the one they were created on, so only the sum over all threads means much
+  std::int64_t live_frames() const { return static_cast<std::int64_t>(frames_created - frames_destroyed); }
+
+  report& merge(report const& other)
+  {
+    schedule_to_resume.merge(other.schedule_to_resume);
+    active.merge(other.active);
+    for (std::size_t i = 0; i < rejection_count; ++i)
+    {
+      rejected[i] += other.rejected[i];
+    }
+    frames_created += other.frames_created;
+    frames_destroyed += other.frames_destroyed;
+    return *this;
+  }
+};
+
+#ifdef BASIC_COROUTINE_METRICS
+
+namespace details
+{
+
+// written by its thread only, read by anyone
+class counter
+{
+  std::atomic<std::uint64_t> m_value{ 0 };
+
+public:
+  void add(std::uint64_t n = 1) { m_value.store(m_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+  std::uint64_t load() const { return m_value.load(std::memory_order_relaxed); }
+};
+
+class histogram
+{
+  std::array<counter, histogram_snapshot::bucket_count> m_buckets{};
+  counter m_count{};
+  counter m_sum{};
+  std::atomic<std::uint64_t> m_max{ 0 };
+
+public:
+  void record(std::uint64_t value)
+  {
+    m_buckets[histogram_snapshot::bucket_of(value)].add();
+    m_count.add();
+    m_sum.add(value);
+    if (value > m_max.load(std::memory_order_relaxed))
+    {
+      m_max.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  void add_to(histogram_snapshot& snapshot) const
+  {
+    for (std::size_t i = 0; i < histogram_snapshot::bucket_count; ++i)
+    {
+      snapshot.buckets[i] += m_buckets[i].load();
+    }
+    snapshot.count += m_count.load();
+    snapshot.sum += m_sum.load();
+    snapshot.max = std::max(snapshot.max, m_max.load(std::memory_order_relaxed));
+  }
+};
+
+struct thread_metrics
+{
+  histogram schedule_to_resume{};
+  histogram active{};
+  std::array<counter, rejection_count> rejected{};
+  counter frames_created{};
+  counter frames_destroyed{};
+  thread_metrics* next{ nullptr };
+  thread_metrics* next_retired{ nullptr };
+
+  void add_to(report& r) const
+  {
+    schedule_to_resume.add_to(r.schedule_to_resume);
+    active.add_to(r.active);
+    for (std::size_t i = 0; i < rejection_count; ++i)
+    {
+      r.rejected[i] += rejected[i].load();
+    }
+    r.frames_created += frames_created.load();
+    r.frames_destroyed += frames_destroyed.load();
+  }
+};
+
+// every block of metrics ever created, pushed lock-free and never freed, so that what threads recorded outlives them and
+// threads still running during static destruction find their metrics intact
+inline std::atomic<thread_metrics*>& all_threads()
+{
+  static std::atomic<thread_metrics*> head{ nullptr };
+  return head;
+}
+
+// blocks of exited threads, taken over by the next thread that starts recording
+// the counts are not reset, a block simply goes on adding to what its previous threads left in it, so it is the aggregate of
+// every thread retired into it, a snapshot never sees a count go back and memory is bounded by the threads alive at once
+struct retired_blocks
+{
+  std::mutex lock;
+  thread_metrics* head{ nullptr };
+
+  static retired_blocks& instance()
+  {
+    static retired_blocks* value = new retired_blocks{};
+    return *value;
+  }
+
+  thread_metrics* take()
+  {
+    std::lock_guard guard{ lock };
+    return head ? std::exchange(head, head->next_retired) : nullptr;
+  }
+
+  void put(thread_metrics* block)
+  {
+    std::lock_guard guard{ lock };
+    block->next_retired = std::exchange(head, block);
+  }
+};
+
+inline thread_metrics* acquire_block()
+{
+  if (auto* reused = retired_blocks::instance().take())
+  {
+    return reused;
+  }
+  auto* created = new thread_metrics{};
+  auto& head = all_threads();
+  created->next = head.load(std::memory_order_relaxed);
+  while (!head.compare_exchange_weak(created->next, created, std::memory_order_release, std::memory_order_relaxed))
+  {
+  }
+  return created;
+}
+
+inline thread_local thread_metrics* current_block = nullptr;
+
+// retires the block of its thread when the thread exits
+// a thread recording from a later thread local destructor takes another block and keeps it
+struct block_lease
+{
+  ~block_lease()
+  {
+    if (current_block)
+    {
+      retired_blocks::instance().put(std::exchange(current_block, nullptr));
+    }
+  }
+};
+
+inline thread_local block_lease lease{};
+
+inline thread_metrics& local()
+{
+  if (!current_block)
+  {
+    current_block = acquire_block();
+    (void)&lease;
+  }
+  return *current_block;
+}
+
+inline std::uint64_t now()
+{
+  return static_cast<std::uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+  );
+}
+
+// the per-promise half of the measurements, the time stamps of the last schedule and the last resume
+// each is zero when nothing is pending, so every hook may be called unconditionally
+struct promise_clock
+{
+  std::uint64_t scheduled_at{ 0 };
+  std::uint64_t activated_at{ 0 };
+
+  void scheduled() { scheduled_at = now(); }
+
+  void activated()
+  {
+    activated_at = now();
+    if (scheduled_at)
+    {
+      local().schedule_to_resume.record(activated_at - std::exchange(scheduled_at, 0));
+    }
+  }
+
+  void suspended()
+  {
+    if (activated_at)
+    {
+      local().active.record(now() - std::exchange(activated_at, 0));
+    }
+  }
+};
+
+inline void rejected(rejection reason) { local().rejected[static_cast<std::size_t>(reason)].add(); }
+inline void frame_created() { local().frames_created.add(); }
+inline void frame_destroyed() { local().frames_destroyed.add(); }
+
+} // end namespace details
+
+// the metrics of all threads, merged, may be taken at any time
+inline report snapshot()
+{
+  report merged{};
+  for (auto* t = details::all_threads().load(std::memory_order_acquire); t; t = t->next)
+  {
+    t->add_to(merged);
+  }
+  return merged;
+}
+
+#else
+
+namespace details
+{
+
+struct promise_clock
+{
+  void scheduled() {}
+  void activated() {}
+  void suspended() {}
+};
+
+inline void rejected(rejection) {}
+inline void frame_created() {}
+inline void frame_destroyed() {}
+
+} // end namespace details
+
+// nothing is collected, an empty report
+inline report snapshot() { return {}; }
+
+#endif
+
+} // end namespace tmf::metrics
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tmf
+{
+
+// one of `count` parts of a partitioned generator, what a generator factory is invoked with by `parallel_consume`
+struct shard
+{
+  std::size_t index;
+  std::size_t count;
+
+  // the part of `[first, last)` this shard covers, consecutive shards cover consecutive parts of nearly equal size
+  template<std::integral I>
+  std::pair<I, I> bounds(I first, I last) const
+  {
+    auto const size = static_cast<std::size_t>(last - first);
+    std::size_t const base = size / count;
+    std::size_t const extra = size % count;
+    std::size_t const begin = index * base + std::min(index, extra);
+    std::size_t const end = begin + base + (index < extra ? 1 : 0);
+    return { static_cast<I>(first + static_cast<I>(begin)), static_cast<I>(first + static_cast<I>(end)) };
+  }
+};
+
+inline namespace details
+{
+
+template<typename Sink>
+concept MergeableSink = requires(Sink& into, Sink&& from) { into.merge(std::move(from)); };
+
+// what the calling thread and the jobs it scheduled share, kept alive by whichever of them lets go of it last
+// shards are claimed from a counter, so a job that runs late finds nothing left and the caller never depends on the executor
+template<typename Factory, typename Sink>
+class parallel_run
+{
+  // every shard feeds its own sink, on its own cache line so that shards running side by side do not slow each other down
+  struct alignas(64) slot
+  {
+    Sink sink;
+  };
+
+  Factory m_factory;
+  std::size_t const m_shards;
+  std::vector<slot> m_slots;
+  std::atomic<std::size_t> m_next{ 0 };
+  std::atomic<std::size_t> m_remaining;
+  std::atomic<bool> m_failed{ false };
+  std::mutex m_error_mutex;
+  std::exception_ptr m_error{};
+
+  void consume(std::size_t index)
+  {
+    auto&& values = std::invoke(m_factory, shard{ index, m_shards });
+    Sink& sink = m_slots[index].sink;
+    for (auto&& value : values)
+    {
+      sink(std::forward<decltype(value)>(value));
+    }
+  }
+
+public:
+  parallel_run(Factory factory, std::size_t shards, Sink const& prototype)
+    : m_factory{ std::move(factory) }
+    , m_shards{ shards }
+    , m_slots(shards, slot{ prototype })
+    , m_remaining{ shards }
+  {
+  }
+
+  // consumes shards until none is left to claim
+  void work()
+  {
+    for (std::size_t index; (index = m_next.fetch_add(1, std::memory_order_relaxed)) < m_shards;)
+    {
+      // once a shard failed the others are skipped, the error is what the caller gets anyway
+      if (!m_failed.load(std::memory_order_relaxed))
+      {
+#if __cpp_exceptions
+        try
+        {
+          consume(index);
+        }
+        catch (...)
+        {
+          std::scoped_lock lock{ m_error_mutex };
+          if (!m_error)
+          {
+            m_error = std::current_exception();
+          }
+          m_failed.store(true, std::memory_order_relaxed);
+        }
+#else
+        consume(index);
+#endif
+      }
+      if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        m_remaining.notify_all();
+      }
+    }
+  }
+
+  // blocks until every shard was consumed, then rethrows the first error or hands over the sinks
+  auto finish()
+  {
+    for (auto left = m_remaining.load(std::memory_order_acquire); left; left = m_remaining.load(std::memory_order_acquire))
+    {
+      m_remaining.wait(left, std::memory_order_acquire);
+    }
+    if (m_error)
+    {
+      std::rethrow_exception(m_error);
+    }
+    if constexpr (MergeableSink<Sink>)
+    {
+      Sink merged = std::move(m_slots.front().sink);
+      for (std::size_t i = 1; i < m_shards; ++i)
+      {
+        merged.merge(std::move(m_slots[i].sink));
+      }
+      return merged;
+    }
+    else
+    {
+      std::vector<Sink> sinks;
+      sinks.reserve(m_shards);
+      for (auto& s : m_slots)
+      {
+        sinks.push_back(std::move(s.sink));
+      }
+      return sinks;
+    }
+  }
+};
+
+} // end namespace details
+
+// consumes a partitioned generator on `executor`, `factory(tmf::shard{ i, shards })` creates the generator of shard `i`, any
+// input range works, a pipeline for instance
+// every shard feeds its own copy of `sink` with `sink(value)`, so sinks need no synchronization, and the factory is called
+// from several threads at once
+// the calling thread consumes shards too and returns once all are done, so a caller that is itself a worker of `executor`
+// cannot deadlock, the executor only has to accept `void()` callables, `tmf::work_stealing_executor` for instance
+// returns the sinks merged in shard order when `Sink` has `merge(Sink&&)`, otherwise a vector of them in shard order
+// the first exception a shard throws is rethrown once the shards that were already running finished, the rest are skipped
+template<typename Factory, typename Executor, typename Sink>
+requires std::ranges::input_range<std::invoke_result_t<Factory&, shard>> && std::copy_constructible<Sink>
+auto parallel_consume(Factory factory, std::size_t shards, Executor&& executor, Sink sink)
+{
+  shards = std::max<std::size_t>(shards, 1);
+  auto run = std::make_shared<details::parallel_run<Factory, Sink>>(std::move(factory), shards, sink);
+  // one job fewer than there are shards, the calling thread takes the remaining one
+  for (std::size_t i = 1; i < shards; ++i)
+  {
+    executor([run]() { run->work(); });
+  }
+  run->work();
+  return run->finish();
+}
+
+} // end namespace tmf
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tmf
+{
+
+inline namespace details
+{
+
+// every stage takes one value at a time and hands what it produces to `next`, which returns whether a value reached the end
+// of the pipeline, so a single pull loop drives all of them and no stage needs a frame or a buffer of its own
+// `finished` tells the loop to stop pulling, `flush` hands over what a stage still holds once nothing more comes
+
+template<typename F, typename In>
+class map_stage
+{
+  F m_f;
+
+public:
+  using output = std::invoke_result_t<F&, In>;
+
+  explicit map_stage(F f) : m_f{ std::move(f) } {}
+
+  template<typename Next>
+  bool push(In value, Next&& next) { return next(std::invoke(m_f, std::forward<In>(value))); }
+
+  template<typename Next>
+  bool flush(Next&&) { return false; }
+
+  bool finished() const { return false; }
+};
+
+template<typename P, typename In>
+class filter_stage
+{
+  P m_predicate;
+
+public:
+  using output = In;
+
+  explicit filter_stage(P predicate) : m_predicate{ std::move(predicate) } {}
+
+  template<typename Next>
+  bool push(In value, Next&& next)
+  {
+    return std::invoke(m_predicate, std::as_const(value)) && next(std::forward<In>(value));
+  }
+
+  template<typename Next>
+  bool flush(Next&&) { return false; }
+
+  bool finished() const { return false; }
+};
+
+template<typename In>
+class take_stage
+{
+  std::size_t m_left;
+
+public:
+  using output = In;
+
+  explicit take_stage(std::size_t count) : m_left{ count } {}
+
+  template<typename Next>
+  bool push(In value, Next&& next)
+  {
+    if (m_left == 0)
+    {
+      return false;
+    }
+    --m_left;
+    return next(std::forward<In>(value));
+  }
+
+  template<typename Next>
+  bool flush(Next&&) { return false; }
+
+  // the source is not resumed once more than needed, an endless generator may be taken from
+  bool finished() const { return m_left == 0; }
+};
+
+// hands over a span of its own buffer, valid until the next value is pulled, the buffer is reused for every chunk
+template<typename In>
+class chunk_stage
+{
+  using value_type = std::remove_cvref_t<In>;
+
+  std::vector<value_type> m_buffer;
+  std::size_t m_size;
+  bool m_handed_over{ false };
+
+public:
+  using output = std::span<value_type const>;
+
+  explicit chunk_stage(std::size_t size)
+    : m_size{ size }
+  {
+    m_buffer.reserve(size);
+  }
+
+  template<typename Next>
+  bool push(In value, Next&& next)
+  {
+    if (std::exchange(m_handed_over, false))
+    {
+      m_buffer.clear();
+    }
+    m_buffer.push_back(std::forward<In>(value));
+    if (m_buffer.size() < m_size)
+    {
+      return false;
+    }
+    m_handed_over = true;
+    return next(output{ m_buffer });
+  }
+
+  // the last chunk may be short
+  template<typename Next>
+  bool flush(Next&& next)
+  {
+    if (m_handed_over || m_buffer.empty())
+    {
+      return false;
+    }
+    m_handed_over = true;
+    return next(output{ m_buffer });
+  }
+
+  bool finished() const { return false; }
+};
+
+// what `tmf::map` and the others return, turned into a stage once the type it is fed is known
+
+template<typename F>
+struct map_adaptor
+{
+  F f;
+
+  template<typename In>
+  auto stage() && { return map_stage<F, In>{ std::move(f) }; }
+};
+
+template<typename P>
+struct filter_adaptor
+{
+  P predicate;
+
+  template<typename In>
+  auto stage() && { return filter_stage<P, In>{ std::move(predicate) }; }
+};
+
+struct take_adaptor
+{
+  std::size_t count;
+
+  template<typename In>
+  auto stage() && { return take_stage<In>{ count }; }
+};
+
+struct chunk_adaptor
+{
+  std::size_t size;
+
+  template<typename In>
+  auto stage() && { return chunk_stage<In>{ size }; }
+};
+
+template<typename T>
+inline constexpr bool is_pipeline_adaptor = false;
+template<typename F>
+inline constexpr bool is_pipeline_adaptor<map_adaptor<F>> = true;
+template<typename P>
+inline constexpr bool is_pipeline_adaptor<filter_adaptor<P>> = true;
+template<>
+inline constexpr bool is_pipeline_adaptor<take_adaptor> = true;
+template<>
+inline constexpr bool is_pipeline_adaptor<chunk_adaptor> = true;
+
+template<typename In, typename... Stages>
+struct output_of
+{
+  using type = In;
+};
+
+template<typename In, typename Stage, typename... Stages>
+struct output_of<In, Stage, Stages...>
+{
+  using type = typename output_of<typename Stage::output, Stages...>::type;
+};
+
+} // end namespace details
+
+// a source range followed by stages, fused into one `std::ranges::input_range`
+// incrementing pulls values from the source and pushes each through every stage in turn until one comes out at the end, the
+// stages are plain objects inlined into that loop, so a pipeline costs one resume of the source per value and no frame per stage
+// what comes out is read in place when a stage passed on a reference, the value yielded by a `generator` for instance, and is
+// only moved into the pipeline when a stage produced a new one, either way it stays valid until the next increment
+// the source is advanced lazily, right before the next value is pulled, so a value referenced from its frame is still there
+// like `generator` a pipeline is single-pass, `begin` is called once
+template<std::ranges::view View, typename... Stages>
+class pipeline
+{
+  template<std::ranges::view, typename...>
+  friend class pipeline;
+
+  using source_reference = std::ranges::range_reference_t<View>;
+
+public:
+  using output = typename details::output_of<source_reference, Stages...>::type;
+  using value_type = std::remove_cvref_t<output>;
+
+private:
+  static constexpr std::size_t stage_count = sizeof...(Stages);
+
+  View m_source;
+  std::tuple<Stages...> m_stages;
+  std::optional<std::ranges::iterator_t<View>> m_position{};
+  bool m_advance{ false };
+  std::size_t m_flushing{ 0 };
+  std::optional<value_type> m_value{};
+  value_type const* m_current{ nullptr };
+
+  template<typename U>
+  bool emit(U&& value)
+  {
+    if constexpr (std::is_lvalue_reference_v<U>)
+    {
+      m_current = std::addressof(value);
+    }
+    else
+    {
+      m_current = std::addressof(m_value.emplace(std::forward<U>(value)));
+    }
+    return true;
+  }
+
+  template<std::size_t I, typename U>
+  bool feed(U&& value)
+  {
+    if constexpr (I == stage_count)
+    {
+      return emit(std::forward<U>(value));
+    }
+    else
+    {
+      return std::get<I>(m_stages).push(std::forward<U>(value), [this](auto&& produced) {
+        return feed<I + 1>(std::forward<decltype(produced)>(produced));
+      });
+    }
+  }
+
+  template<std::size_t I = 0>
+  bool flush(std::size_t index)
+  {
+    if constexpr (I == stage_count)
+    {
+      return false;
+    }
+    else if (I != index)
+    {
+      return flush<I + 1>(index);
+    }
+    else
+    {
+      return std::get<I>(m_stages).flush([this](auto&& produced) {
+        return feed<I + 1>(std::forward<decltype(produced)>(produced));
+      });
+    }
+  }
+
+  bool finished() const
+  {
+    return std::apply([](auto const&... stages) { return (stages.finished() || ...); }, m_stages);
+  }
+
+  void pull()
+  {
+    m_current = nullptr;
+    while (!finished())
+    {
+      if (!m_position)
+      {
+        m_position.emplace(std::ranges::begin(m_source));
+      }
+      else if (std::exchange(m_advance, false))
+      {
+        ++*m_position;
+      }
+      if (*m_position == std::ranges::end(m_source))
+      {
+        break;
+      }
+      m_advance = true;
+      auto&& value = **m_position;
+      if (feed<0>(std::forward<decltype(value)>(value)))
+      {
+        return;
+      }
+    }
+    // the source ended or a stage wants nothing more, what stages still hold comes out one value at a time
+    for (; m_flushing < stage_count; ++m_flushing)
+    {
+      if (flush(m_flushing))
+      {
+        return;
+      }
+    }
+  }
+
+public:
+  class iterator
+  {
+    pipeline* m_pipeline{ nullptr };
+
+    bool ended() const { return !m_pipeline->m_current; }
+
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = typename pipeline::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type const&;
+
+    iterator() = default;
+    explicit iterator(pipeline& p) : m_pipeline{ std::addressof(p) } {}
+
+    reference operator*() const { return *m_pipeline->m_current; }
+    value_type const* operator->() const { return m_pipeline->m_current; }
+
+    iterator& operator++()
+    {
+      m_pipeline->pull();
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(iterator const& it, std::default_sentinel_t) { return it.ended(); }
+  };
+
+  pipeline(View source, std::tuple<Stages...> stages)
+    : m_source{ std::move(source) }
+    , m_stages{ std::move(stages) }
+  {
+  }
+
+  pipeline(pipeline&&) = default;
+  pipeline& operator=(pipeline&&) = default;
+
+  // pulls the first value, call once
+  iterator begin()
+  {
+    pull();
+    return iterator{ *this };
+  }
+
+  std::default_sentinel_t end() const { return std::default_sentinel; }
+
+  // another stage fused into the same loop
+  template<typename Adaptor>
+  requires details::is_pipeline_adaptor<Adaptor>
+  friend auto operator|(pipeline&& self, Adaptor adaptor)
+  {
+    using stage = decltype(std::move(adaptor).template stage<output>());
+    return pipeline<View, Stages..., stage>{
+      std::move(self.m_source),
+      std::tuple_cat(std::move(self.m_stages), std::tuple<stage>{ std::move(adaptor).template stage<output>() })
+    };
+  }
+};
+
+namespace details
+{
+
+template<typename T>
+inline constexpr bool is_pipeline = false;
+template<typename View, typename... Stages>
+inline constexpr bool is_pipeline<pipeline<View, Stages...>> = true;
+
+// a range given as an lvalue is referenced, even one that cannot be copied such as `generator`, an rvalue is moved in
+template<typename Range>
+auto source_view(Range&& source)
+{
+  if constexpr (std::is_lvalue_reference_v<Range>)
+  {
+    return std::ranges::ref_view{ source };
+  }
+  else
+  {
+    return std::views::all(std::move(source));
+  }
+}
+
+// starts a pipeline, declared next to the adaptors so that it is found whatever namespace the range comes from
+template<std::ranges::input_range Range, typename Adaptor>
+requires is_pipeline_adaptor<Adaptor> && (!is_pipeline<std::remove_cvref_t<Range>>)
+auto operator|(Range&& source, Adaptor adaptor)
+{
+  using view = decltype(source_view(std::forward<Range>(source)));
+  return pipeline<view>{ source_view(std::forward<Range>(source)), {} } | std::move(adaptor);
+}
+
+} // end namespace details
+
+// `f(value)` for every value, a reference it returns has to stay valid until the next value is pulled
+template<typename F>
+auto map(F f)
+{
+  return details::map_adaptor<F>{ std::move(f) };
+}
+
+// only the values for which `predicate(value)` holds
+template<typename P>
+auto filter(P predicate)
+{
+  return details::filter_adaptor<P>{ std::move(predicate) };
+}
+
+// at most `count` values, the source is not resumed afterwards
+inline auto take(std::size_t count)
+{
+  return details::take_adaptor{ count };
+}
+
+// spans of `size` consecutive values, the last one shorter when the values run out
+inline auto chunk(std::size_t size)
+{
+  return details::chunk_adaptor{ size };
+}
+
+} // end namespace tmf
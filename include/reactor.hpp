@@ -0,0 +1,671 @@
+#pragma once
+
+#include <contract.hpp>
+#include <continuation.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace tmf
+{
+
+class reactor;
+
+// the outcome of an I/O operation, a byte count or file descriptor on success and a negated errno on failure
+struct io_result
+{
+  int value;
+
+  bool ok() const { return value >= 0; }
+  std::size_t bytes() const { return ok() ? static_cast<std::size_t>(value) : 0; }
+  std::error_code error() const { return ok() ? std::error_code{} : std::error_code{ -value, std::system_category() }; }
+};
+
+// a single read, write or accept, awaited from a coroutine
+// it lives in the awaiting coroutine's frame for the whole operation, the reactor only keeps a pointer to it
+// buffers are handed to the kernel as is, nothing is copied
+struct io_operation
+{
+  enum class kind
+  {
+    read,
+    write,
+    accept
+  };
+
+  reactor* owner;
+  kind op;
+  int fd;
+  void* buffer{ nullptr };
+  std::size_t length{ 0 };
+  std::int64_t offset{ -1 }; // -1 uses and advances the file position
+  sockaddr* address{ nullptr };
+  socklen_t* address_length{ nullptr };
+  int flags{ 0 };
+
+  parked_coroutine waiter{};
+  int result{ 0 };
+  io_operation* next_waiting{ nullptr }; // used by the epoll backend only
+
+  bool await_ready() { return false; }
+  template<typename Promise>
+  bool await_suspend(std::coroutine_handle<Promise> handle);
+  io_result await_resume() { return { result }; }
+};
+
+enum class reactor_backend
+{
+  automatic, // io_uring when the kernel allows it, epoll otherwise
+  io_uring,
+  epoll
+};
+
+// drives the I/O of coroutines suspended on `io_operation`s, from a single thread
+// with io_uring operations are queued when awaited and submitted in one batch by the next `poll`
+// with epoll operations wait for readiness and are performed by `poll`, regular files complete immediately
+class reactor
+{
+  struct uring
+  {
+    int fd{ -1 };
+    unsigned features{ 0 };
+
+    void* sq_ring{ MAP_FAILED };
+    std::size_t sq_ring_size{ 0 };
+    void* cq_ring{ MAP_FAILED };
+    std::size_t cq_ring_size{ 0 };
+    io_uring_sqe* sqes{ static_cast<io_uring_sqe*>(MAP_FAILED) };
+    std::size_t sqes_size{ 0 };
+
+    unsigned* sq_head{ nullptr };
+    unsigned* sq_tail{ nullptr };
+    unsigned* sq_array{ nullptr };
+    unsigned sq_mask{ 0 };
+    unsigned sq_entries{ 0 };
+    unsigned* cq_head{ nullptr };
+    unsigned* cq_tail{ nullptr };
+    unsigned cq_mask{ 0 };
+    io_uring_cqe* cqes{ nullptr };
+
+    unsigned prepared_tail{ 0 }; // sqes written but not yet published to the kernel
+    unsigned unsubmitted{ 0 };
+  };
+
+  // operations waiting on the readiness of one file descriptor
+  struct watch
+  {
+    io_operation* readers{ nullptr };
+    io_operation* writers{ nullptr };
+    std::uint32_t events{ 0 };
+  };
+
+  reactor_backend m_backend;
+  uring m_ring{};
+  int m_epoll{ -1 };
+  std::unordered_map<int, watch> m_watches;
+  std::size_t m_in_flight{ 0 };
+
+  static reactor*& current_slot()
+  {
+    static thread_local reactor* value{ nullptr };
+    return value;
+  }
+
+  // a system call failing outside of any one operation leaves the reactor unusable, it is reported through the contract
+  // policy, with the errno spelled out, failures of an operation are its `io_result`
+  [[noreturn]] static void fail(char const* what)
+  {
+    static thread_local char message[256];
+    std::snprintf(message, sizeof(message), "%s: %s", what, std::strerror(errno));
+    details::contract_violation(message);
+  }
+
+  static int enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, void* arg, std::size_t arg_size)
+  {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+  }
+
+  bool setup_uring(unsigned entries)
+  {
+    io_uring_params params{};
+    int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0)
+    {
+      return false;
+    }
+    m_ring.fd = fd;
+    m_ring.features = params.features;
+    m_ring.sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_ring.cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool const single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap)
+    {
+      m_ring.sq_ring_size = m_ring.cq_ring_size = std::max(m_ring.sq_ring_size, m_ring.cq_ring_size);
+    }
+    m_ring.sq_ring = ::mmap(nullptr, m_ring.sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (m_ring.sq_ring == MAP_FAILED)
+    {
+      return false;
+    }
+    m_ring.cq_ring = single_mmap
+      ? m_ring.sq_ring
+      : ::mmap(nullptr, m_ring.cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (m_ring.cq_ring == MAP_FAILED)
+    {
+      return false;
+    }
+    m_ring.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    m_ring.sqes = static_cast<io_uring_sqe*>(
+      ::mmap(nullptr, m_ring.sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    if (m_ring.sqes == MAP_FAILED)
+    {
+      return false;
+    }
+    auto* sq = static_cast<char*>(m_ring.sq_ring);
+    auto* cq = static_cast<char*>(m_ring.cq_ring);
+    m_ring.sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    m_ring.sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    m_ring.sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    m_ring.sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    m_ring.sq_entries = params.sq_entries;
+    m_ring.cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    m_ring.cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    m_ring.cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    m_ring.cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    m_ring.prepared_tail = *m_ring.sq_tail;
+    return true;
+  }
+
+  void teardown_uring()
+  {
+    if (m_ring.sqes != MAP_FAILED)
+    {
+      ::munmap(m_ring.sqes, m_ring.sqes_size);
+    }
+    if (m_ring.cq_ring != MAP_FAILED && m_ring.cq_ring != m_ring.sq_ring)
+    {
+      ::munmap(m_ring.cq_ring, m_ring.cq_ring_size);
+    }
+    if (m_ring.sq_ring != MAP_FAILED)
+    {
+      ::munmap(m_ring.sq_ring, m_ring.sq_ring_size);
+    }
+    if (m_ring.fd >= 0)
+    {
+      ::close(m_ring.fd);
+    }
+    m_ring = {};
+  }
+
+  // publishes prepared sqes and enters the kernel, optionally waiting for completions
+  void flush(unsigned min_complete, __kernel_timespec* timeout)
+  {
+    std::atomic_ref<unsigned>{ *m_ring.sq_tail }.store(m_ring.prepared_tail, std::memory_order_release);
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    io_uring_getevents_arg arg{};
+    void* arg_ptr = nullptr;
+    std::size_t arg_size = 0;
+    if (timeout && min_complete)
+    {
+      arg.ts = reinterpret_cast<std::uint64_t>(timeout);
+      arg_ptr = &arg;
+      arg_size = sizeof(arg);
+      flags |= IORING_ENTER_EXT_ARG;
+    }
+    while (true)
+    {
+      int submitted = enter(m_ring.fd, m_ring.unsubmitted, min_complete, flags, arg_ptr, arg_size);
+      if (submitted >= 0)
+      {
+        m_ring.unsubmitted -= static_cast<unsigned>(submitted);
+        return;
+      }
+      if (errno == ETIME || errno == EINTR)
+      {
+        if (errno == EINTR && m_ring.unsubmitted)
+        {
+          continue;
+        }
+        return;
+      }
+      if (errno == EBUSY || errno == EAGAIN)
+      {
+        // the completion queue is full, it is drained right after this
+        return;
+      }
+      fail("[Error]@[Reactor]: io_uring_enter failed");
+    }
+  }
+
+  io_uring_sqe& next_sqe()
+  {
+    unsigned head = std::atomic_ref<unsigned>{ *m_ring.sq_head }.load(std::memory_order_acquire);
+    if (m_ring.prepared_tail - head == m_ring.sq_entries)
+    {
+      flush(0, nullptr);
+    }
+    unsigned index = m_ring.prepared_tail & m_ring.sq_mask;
+    io_uring_sqe& sqe = m_ring.sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    m_ring.sq_array[index] = index;
+    ++m_ring.prepared_tail;
+    ++m_ring.unsubmitted;
+    return sqe;
+  }
+
+  void queue_uring(io_operation& operation)
+  {
+    io_uring_sqe& sqe = next_sqe();
+    sqe.fd = operation.fd;
+    sqe.user_data = reinterpret_cast<std::uint64_t>(&operation);
+    switch (operation.op)
+    {
+      case io_operation::kind::read:
+        sqe.opcode = IORING_OP_READ;
+        sqe.addr = reinterpret_cast<std::uint64_t>(operation.buffer);
+        sqe.len = static_cast<unsigned>(operation.length);
+        sqe.off = static_cast<std::uint64_t>(operation.offset);
+        break;
+      case io_operation::kind::write:
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.addr = reinterpret_cast<std::uint64_t>(operation.buffer);
+        sqe.len = static_cast<unsigned>(operation.length);
+        sqe.off = static_cast<std::uint64_t>(operation.offset);
+        break;
+      case io_operation::kind::accept:
+        sqe.opcode = IORING_OP_ACCEPT;
+        sqe.addr = reinterpret_cast<std::uint64_t>(operation.address);
+        sqe.addr2 = reinterpret_cast<std::uint64_t>(operation.address_length);
+        sqe.accept_flags = static_cast<std::uint32_t>(operation.flags);
+        break;
+    }
+  }
+
+  std::size_t reap_uring()
+  {
+    std::size_t resumed = 0;
+    unsigned head = *m_ring.cq_head;
+    while (head != std::atomic_ref<unsigned>{ *m_ring.cq_tail }.load(std::memory_order_acquire))
+    {
+      io_uring_cqe const& cqe = m_ring.cqes[head & m_ring.cq_mask];
+      auto* operation = reinterpret_cast<io_operation*>(cqe.user_data);
+      int const result = cqe.res;
+      std::atomic_ref<unsigned>{ *m_ring.cq_head }.store(++head, std::memory_order_release);
+      if (operation)
+      {
+        operation->result = result;
+        --m_in_flight;
+        ++resumed;
+        operation->waiter().resume();
+      }
+    }
+    return resumed;
+  }
+
+  std::size_t poll_uring(std::chrono::milliseconds timeout)
+  {
+    std::size_t resumed = reap_uring();
+    if (resumed || timeout.count() == 0 || m_in_flight == 0)
+    {
+      if (m_ring.unsubmitted)
+      {
+        flush(0, nullptr);
+      }
+      return resumed + reap_uring();
+    }
+    __kernel_timespec ts{};
+    __kernel_timespec* ts_ptr = nullptr;
+    if (timeout.count() > 0)
+    {
+      ts.tv_sec = timeout.count() / 1000;
+      ts.tv_nsec = (timeout.count() % 1000) * 1'000'000;
+      if (m_ring.features & IORING_FEAT_EXT_ARG)
+      {
+        ts_ptr = &ts;
+      }
+      else
+      {
+        // older kernels, a timeout request without an operation behind it (`user_data` 0) ends the wait
+        io_uring_sqe& sqe = next_sqe();
+        sqe.opcode = IORING_OP_TIMEOUT;
+        sqe.addr = reinterpret_cast<std::uint64_t>(&ts);
+        sqe.len = 1;
+        sqe.user_data = 0;
+      }
+    }
+    flush(1, ts_ptr);
+    return reap_uring();
+  }
+
+  // performs a ready operation with a plain system call, returns false while it would still block
+  static bool perform(io_operation& operation)
+  {
+    ssize_t result = -1;
+    switch (operation.op)
+    {
+      case io_operation::kind::read:
+        result = operation.offset < 0
+          ? ::read(operation.fd, operation.buffer, operation.length)
+          : ::pread(operation.fd, operation.buffer, operation.length, operation.offset);
+        break;
+      case io_operation::kind::write:
+        result = operation.offset < 0
+          ? ::write(operation.fd, operation.buffer, operation.length)
+          : ::pwrite(operation.fd, operation.buffer, operation.length, operation.offset);
+        break;
+      case io_operation::kind::accept:
+        result = ::accept4(operation.fd, operation.address, operation.address_length, operation.flags);
+        break;
+    }
+    if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+      return false;
+    }
+    operation.result = result < 0 ? -errno : static_cast<int>(result);
+    return true;
+  }
+
+  // returns 0, or the errno of a failed `epoll_ctl`
+  int update_interest(int fd, watch& w)
+  {
+    std::uint32_t wanted = (w.readers ? EPOLLIN : 0u) | (w.writers ? EPOLLOUT : 0u);
+    if (wanted == w.events)
+    {
+      return 0;
+    }
+    epoll_event event{};
+    event.events = wanted;
+    event.data.fd = fd;
+    int op = w.events == 0 ? EPOLL_CTL_ADD : wanted == 0 ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
+    if (::epoll_ctl(m_epoll, op, fd, &event) < 0)
+    {
+      return errno;
+    }
+    w.events = wanted;
+    return 0;
+  }
+
+  // returns false when the operation completed on the spot
+  bool queue_epoll(io_operation& operation)
+  {
+    auto& w = m_watches[operation.fd];
+    bool const reading = operation.op != io_operation::kind::write;
+    io_operation** list = reading ? &w.readers : &w.writers;
+    bool const first = *list == nullptr;
+    operation.next_waiting = nullptr;
+    while (*list)
+    {
+      list = &(*list)->next_waiting;
+    }
+    *list = &operation;
+    if (!first)
+    {
+      return true;
+    }
+    epoll_event event{};
+    event.events = w.events | (reading ? EPOLLIN : EPOLLOUT);
+    event.data.fd = operation.fd;
+    if (::epoll_ctl(m_epoll, w.events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, operation.fd, &event) < 0)
+    {
+      int const error = errno;
+      *(reading ? &w.readers : &w.writers) = nullptr;
+      if (!w.readers && !w.writers)
+      {
+        m_watches.erase(operation.fd);
+      }
+      // regular files cannot be polled and never block, perform it right away, any other failure is the result
+      if (error == EPERM)
+      {
+        perform(operation);
+      }
+      else
+      {
+        operation.result = -error;
+      }
+      return false;
+    }
+    w.events = event.events;
+    return true;
+  }
+
+  std::size_t poll_epoll(std::chrono::milliseconds timeout)
+  {
+    if (m_in_flight == 0)
+    {
+      return 0;
+    }
+    epoll_event events[64];
+    int count = ::epoll_wait(m_epoll, events, 64, static_cast<int>(timeout.count()));
+    if (count < 0)
+    {
+      if (errno == EINTR)
+      {
+        return 0;
+      }
+      fail("[Error]@[Reactor]: epoll_wait failed");
+    }
+    // collect first, resuming may queue new operations and rehash the watches
+    io_operation* completed = nullptr;
+    io_operation** completed_tail = &completed;
+    for (int i = 0; i < count; ++i)
+    {
+      int fd = events[i].data.fd;
+      auto found = m_watches.find(fd);
+      if (found == m_watches.end())
+      {
+        continue;
+      }
+      watch& w = found->second;
+      bool const failed = events[i].events & (EPOLLERR | EPOLLHUP);
+      for (auto [list, ready] : { std::pair{ &w.readers, (events[i].events & EPOLLIN) || failed },
+                                  std::pair{ &w.writers, (events[i].events & EPOLLOUT) || failed } })
+      {
+        while (ready && *list && perform(**list))
+        {
+          io_operation* done = std::exchange(*list, (*list)->next_waiting);
+          done->next_waiting = nullptr;
+          *completed_tail = done;
+          completed_tail = &done->next_waiting;
+        }
+      }
+      if (int const error = update_interest(fd, w))
+      {
+        // the descriptor cannot be watched any more, whatever still waits on it completes with the error
+        for (io_operation** list : { &w.readers, &w.writers })
+        {
+          while (*list)
+          {
+            io_operation* done = std::exchange(*list, (*list)->next_waiting);
+            done->result = -error;
+            done->next_waiting = nullptr;
+            *completed_tail = done;
+            completed_tail = &done->next_waiting;
+          }
+        }
+        w.events = 0;
+      }
+      if (w.events == 0)
+      {
+        m_watches.erase(found);
+      }
+    }
+    std::size_t resumed = 0;
+    while (completed)
+    {
+      io_operation* done = std::exchange(completed, completed->next_waiting);
+      --m_in_flight;
+      ++resumed;
+      done->waiter().resume();
+    }
+    return resumed;
+  }
+
+public:
+  explicit reactor(unsigned entries = 256, reactor_backend backend = reactor_backend::automatic)
+    : m_backend{ backend }
+  {
+    if (backend != reactor_backend::epoll)
+    {
+      if (setup_uring(entries))
+      {
+        m_backend = reactor_backend::io_uring;
+      }
+      else
+      {
+        int error = errno;
+        teardown_uring();
+        if (backend == reactor_backend::io_uring)
+        {
+          errno = error;
+          fail("[Error]@[Reactor]: io_uring is unavailable");
+        }
+        m_backend = reactor_backend::epoll;
+      }
+    }
+    if (m_backend == reactor_backend::epoll)
+    {
+      m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+      if (m_epoll < 0)
+      {
+        fail("[Error]@[Reactor]: epoll_create1 failed");
+      }
+    }
+    if (!current_slot())
+    {
+      current_slot() = this;
+    }
+  }
+
+  reactor(reactor const&) = delete;
+  void operator=(reactor const&) = delete;
+
+  // coroutines still suspended on an operation are not resumed
+  ~reactor()
+  {
+    if (current_slot() == this)
+    {
+      current_slot() = nullptr;
+    }
+    teardown_uring();
+    if (m_epoll >= 0)
+    {
+      ::close(m_epoll);
+    }
+  }
+
+  // the first reactor created on the calling thread, used by the awaitables that do not name one
+  static reactor* current() { return current_slot(); }
+
+  reactor_backend backend() const { return m_backend; }
+
+  // operations awaited but not yet completed
+  std::size_t in_flight() const { return m_in_flight; }
+
+  // called by `io_operation::await_suspend`, returns false when the operation already completed
+  bool submit(io_operation& operation)
+  {
+    if (m_backend == reactor_backend::io_uring)
+    {
+      queue_uring(operation);
+      ++m_in_flight;
+      return true;
+    }
+    if (queue_epoll(operation))
+    {
+      ++m_in_flight;
+      return true;
+    }
+    return false;
+  }
+
+  // submits queued operations and resumes the coroutines whose operations completed
+  // waits up to `timeout` for a first completion, a negative timeout waits for as long as it takes
+  // returns how many coroutines were resumed
+  std::size_t poll(std::chrono::milliseconds timeout = std::chrono::milliseconds{ 0 })
+  {
+    return m_backend == reactor_backend::io_uring ? poll_uring(timeout) : poll_epoll(timeout);
+  }
+
+  // polls until no operation is left in flight
+  void run()
+  {
+    while (m_in_flight)
+    {
+      poll(std::chrono::milliseconds{ -1 });
+    }
+  }
+};
+
+template<typename Promise>
+bool io_operation::await_suspend(std::coroutine_handle<Promise> handle)
+{
+  waiter.park(handle);
+  return owner->submit(*this);
+}
+
+inline io_operation async_read(reactor& r, int fd, std::span<std::byte> buffer, std::int64_t offset = -1)
+{
+  return { &r, io_operation::kind::read, fd, buffer.data(), buffer.size(), offset };
+}
+
+inline io_operation async_write(reactor& r, int fd, std::span<std::byte const> buffer, std::int64_t offset = -1)
+{
+  return { &r, io_operation::kind::write, fd, const_cast<std::byte*>(buffer.data()), buffer.size(), offset };
+}
+
+inline io_operation async_accept(
+  reactor& r, int fd, sockaddr* address = nullptr, socklen_t* address_length = nullptr, int flags = SOCK_CLOEXEC)
+{
+  return { &r, io_operation::kind::accept, fd, nullptr, 0, -1, address, address_length, flags };
+}
+
+namespace details
+{
+
+inline reactor& current_reactor()
+{
+  details::expects(
+    [] { return reactor::current() != nullptr; },
+    "[Error]@[Reactor]: no reactor was created on this thread, pass one to the operation"
+  );
+  return *reactor::current();
+}
+
+} // end namespace details
+
+// the same operations on `reactor::current()`, which has to exist
+inline io_operation async_read(int fd, std::span<std::byte> buffer, std::int64_t offset = -1)
+{
+  return async_read(details::current_reactor(), fd, buffer, offset);
+}
+
+inline io_operation async_write(int fd, std::span<std::byte const> buffer, std::int64_t offset = -1)
+{
+  return async_write(details::current_reactor(), fd, buffer, offset);
+}
+
+inline io_operation async_accept(
+  int fd, sockaddr* address = nullptr, socklen_t* address_length = nullptr, int flags = SOCK_CLOEXEC)
+{
+  return async_accept(details::current_reactor(), fd, address, address_length, flags);
+}
+
+} // end namespace tmf
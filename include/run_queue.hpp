@@ -0,0 +1,164 @@
+#pragma once
+
+#include <schedule_node.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace tmf
+{
+
+// a single-consumer event loop fed by any number of producer threads
+// the queue is Vyukov's intrusive MPSC queue: a push is one exchange and one store, a pop takes no atomic RMW at all
+// - `execute(schedule_node&)` links a promise's node as is, nothing is allocated
+// - `execute(F&&)` accepts any callable, it is wrapped in a heap allocated node
+// `run_one`, `run_until_idle`, `drain` and `empty` belong to the consumer, they must only be called from one thread at a time
+class run_queue
+{
+  alignas(64) std::atomic<schedule_node*> m_head;
+  alignas(64) schedule_node* m_tail;
+  schedule_node m_stub{};
+
+  template<typename F>
+  struct callable_node : schedule_node
+  {
+    F callable;
+
+    explicit callable_node(F&& init)
+      : callable{ std::move(init) }
+    {
+      run = [](schedule_node* self)
+      {
+        auto* owned = static_cast<callable_node*>(self);
+        owned->callable();
+        delete owned;
+      };
+    }
+  };
+
+  void push(schedule_node& node)
+  {
+    node.next.store(nullptr, std::memory_order_relaxed);
+    schedule_node* previous = m_head.exchange(&node, std::memory_order_acq_rel);
+    // between the exchange and this store the queue is briefly disconnected, `pop` then reports empty
+    previous->next.store(&node, std::memory_order_release);
+  }
+
+  schedule_node* pop()
+  {
+    schedule_node* tail = m_tail;
+    schedule_node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &m_stub)
+    {
+      if (!next)
+      {
+        return nullptr;
+      }
+      m_tail = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+    if (next)
+    {
+      m_tail = next;
+      return tail;
+    }
+    if (tail != m_head.load(std::memory_order_acquire))
+    {
+      // a producer is between its exchange and its store
+      return nullptr;
+    }
+    push(m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
+    {
+      m_tail = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+public:
+  run_queue()
+    : m_head{ &m_stub }
+    , m_tail{ &m_stub }
+  {
+  }
+
+  run_queue(run_queue const&) = delete;
+  void operator=(run_queue const&) = delete;
+
+  // callables still queued are run, so their nodes are released, pushes already under way are waited for
+  ~run_queue() { drain(); }
+
+  void execute(schedule_node& node)
+  {
+    push(node);
+  }
+
+  template<typename F>
+  requires (!std::is_base_of_v<schedule_node, std::remove_cvref_t<F>>)
+  void execute(F&& callable)
+  {
+    push(*new callable_node<std::decay_t<F>>{ std::decay_t<F>(std::forward<F>(callable)) });
+  }
+
+  template<typename F>
+  void operator()(F&& callable)
+  {
+    execute(std::forward<F>(callable));
+  }
+
+  // runs at most one queued node, returns whether one ran
+  bool run_one()
+  {
+    if (schedule_node* node = pop())
+    {
+      (*node)();
+      return true;
+    }
+    return false;
+  }
+
+  // runs nodes until the queue is observed empty, including nodes queued while running, returns how many ran
+  std::size_t run_until_idle()
+  {
+    std::size_t count = 0;
+    while (run_one())
+    {
+      ++count;
+    }
+    return count;
+  }
+
+  // like `run_until_idle`, but also waits for producers that are in the middle of a push, so the queue is empty afterwards
+  // unless another push began meanwhile
+  std::size_t drain()
+  {
+    std::size_t count = run_until_idle();
+    while (!empty())
+    {
+      if (run_one())
+      {
+        ++count;
+      }
+      else
+      {
+        // a producer is between its exchange and its store
+        std::this_thread::yield();
+      }
+    }
+    return count;
+  }
+
+  // consumer only, a push under way already counts, even though `run_one` cannot reach its node yet
+  bool empty() const
+  {
+    return m_tail == &m_stub && m_head.load(std::memory_order_acquire) == &m_stub;
+  }
+};
+
+} // end namespace tmf
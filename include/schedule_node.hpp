@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+
+namespace tmf
+{
+
+// an intrusive run queue entry, the promise of every `NodeScheduledFuture` embeds one
+// an executor receiving a node can link it into its queue as is, scheduling a resume never allocates
+// `run` is filled in by whoever hands the node out, `next` belongs to the executor while the node is queued
+struct schedule_node
+{
+  std::atomic<schedule_node*> next{ nullptr };
+  void (*run)(schedule_node*){ nullptr };
+
+  void operator()() { run(this); }
+};
+
+// a future which hands its promise's node to the executor customization point, as in:
+// `void executor(tmf::schedule_node& node);`
+// a future whose `executor` also accepts callables keeps receiving callables
+template<typename F>
+concept NodeScheduledFuture =
+  requires(F& f, schedule_node& node) { f.executor(node); }
+  && !requires(F& f) { f.executor([]() {}); };
+
+} // end namespace tmf
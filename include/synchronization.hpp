@@ -0,0 +1,470 @@
+#pragma once
+
+#include <contract.hpp>
+#include <waker.hpp>
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace tmf
+{
+
+// coroutine counterparts of the blocking primitives, `co_await` suspends the coroutine instead of the thread
+// waiters are nodes living in the suspended awaiters, queued on lock-free intrusive lists, nothing is allocated
+// a waiter is woken through its `waker`, so a coroutine with an executor is scheduled on it, any other one is resumed by
+// whoever released it
+
+namespace details
+{
+
+struct waiter
+{
+  waiter* next{ nullptr };
+  waker wake{};
+};
+
+// wakes a list of waiters, taking each link before the node can disappear with its resumed frame
+inline void wake_all(waiter* list)
+{
+  while (list)
+  {
+    waiter* node = std::exchange(list, list->next);
+    node->wake();
+  }
+}
+
+inline waiter* reverse(waiter* list)
+{
+  waiter* reversed = nullptr;
+  while (list)
+  {
+    reversed = std::exchange(list, std::exchange(list->next, reversed));
+  }
+  return reversed;
+}
+
+} // end namespace details
+
+class async_mutex;
+
+// unlocks on destruction, the result of `co_await mutex.scoped_lock()`
+class async_lock_guard
+{
+  async_mutex* m_mutex;
+
+public:
+  explicit async_lock_guard(async_mutex& mutex)
+    : m_mutex{ &mutex }
+  {
+  }
+
+  async_lock_guard(async_lock_guard&& other)
+    : m_mutex{ std::exchange(other.m_mutex, nullptr) }
+  {
+  }
+
+  async_lock_guard(async_lock_guard const&) = delete;
+  void operator=(async_lock_guard const&) = delete;
+
+  inline ~async_lock_guard();
+};
+
+// a mutex whose `lock` suspends the awaiting coroutine while another one holds it
+// the whole state is one word: unlocked, locked, or the head of a stack of waiters pushed since the holder last looked
+// `unlock` hands the mutex straight to the oldest waiter, it stays locked in between, so a waiter never has to retry
+// the holder keeps the waiters it took off the stack in FIFO order, only the holder ever touches that list
+class async_mutex
+{
+  static constexpr std::uintptr_t unlocked = 1;
+  static constexpr std::uintptr_t locked = 0;
+
+  std::atomic<std::uintptr_t> m_state{ unlocked };
+  details::waiter* m_waiters{ nullptr };
+
+public:
+  async_mutex() = default;
+  async_mutex(async_mutex const&) = delete;
+  void operator=(async_mutex const&) = delete;
+
+  bool try_lock()
+  {
+    std::uintptr_t expected = unlocked;
+    return m_state.compare_exchange_strong(expected, locked, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  // may only be called by the holder, resumes or schedules the next waiter as the new holder
+  void unlock()
+  {
+    if (!m_waiters)
+    {
+      std::uintptr_t expected = locked;
+      if (m_state.compare_exchange_strong(expected, unlocked, std::memory_order_release, std::memory_order_relaxed))
+      {
+        return;
+      }
+      m_waiters = details::reverse(reinterpret_cast<details::waiter*>(m_state.exchange(locked, std::memory_order_acquire)));
+    }
+    details::waiter* next = std::exchange(m_waiters, m_waiters->next);
+    next->wake();
+  }
+
+  // `co_await` returns once the awaiting coroutine holds the mutex
+  class lock_awaiter
+  {
+  protected:
+    async_mutex* m_mutex;
+    details::waiter m_node{};
+
+  public:
+    explicit lock_awaiter(async_mutex& mutex)
+      : m_mutex{ &mutex }
+    {
+    }
+
+    lock_awaiter(lock_awaiter const&) = delete;
+    void operator=(lock_awaiter const&) = delete;
+
+    bool await_ready() { return m_mutex->try_lock(); }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+      m_node.wake = waker::of(handle);
+      std::uintptr_t state = m_mutex->m_state.load(std::memory_order_relaxed);
+      while (true)
+      {
+        if (state == unlocked)
+        {
+          if (m_mutex->m_state.compare_exchange_weak(state, locked, std::memory_order_acquire, std::memory_order_relaxed))
+          {
+            return false;
+          }
+          continue;
+        }
+        m_node.next = reinterpret_cast<details::waiter*>(state);
+        if (m_mutex->m_state.compare_exchange_weak(
+              state, reinterpret_cast<std::uintptr_t>(&m_node), std::memory_order_release, std::memory_order_relaxed))
+        {
+          return true;
+        }
+      }
+    }
+
+    void await_resume() {}
+  };
+
+  class scoped_lock_awaiter : public lock_awaiter
+  {
+  public:
+    using lock_awaiter::lock_awaiter;
+
+    async_lock_guard await_resume() { return async_lock_guard{ *m_mutex }; }
+  };
+
+  lock_awaiter lock() { return lock_awaiter{ *this }; }
+
+  scoped_lock_awaiter scoped_lock() { return scoped_lock_awaiter{ *this }; }
+};
+
+inline async_lock_guard::~async_lock_guard()
+{
+  if (m_mutex)
+  {
+    m_mutex->unlock();
+  }
+}
+
+// a counting semaphore, `acquire` suspends the awaiting coroutine while no permit is left
+// the count goes negative by the number of coroutines that found it empty, so `release` knows how many it owes a permit
+// arriving waiters push themselves on a lock-free stack, permits are handed out to them in FIFO order by whichever thread is
+// draining, the others only leave a note that there is more to do, so neither side ever waits on the other
+class async_semaphore
+{
+  std::atomic<std::ptrdiff_t> m_count;
+  std::atomic<details::waiter*> m_incoming{ nullptr };
+  std::atomic<std::size_t> m_owed{ 0 };     // permits released to waiters not yet taken off the lists
+  std::atomic<std::size_t> m_drainers{ 0 }; // the first to raise it drains until it brings it back to zero
+  details::waiter* m_head{ nullptr };       // FIFO of the drainer
+  details::waiter* m_tail{ nullptr };
+
+  void drain()
+  {
+    if (m_drainers.fetch_add(1, std::memory_order_acq_rel) != 0)
+    {
+      return;
+    }
+    details::waiter* woken = nullptr;
+    details::waiter** woken_tail = &woken;
+    std::size_t requests = 1;
+    do
+    {
+      if (auto* arrived = details::reverse(m_incoming.exchange(nullptr, std::memory_order_acquire)))
+      {
+        (m_tail ? m_tail->next : m_head) = arrived;
+        for (m_tail = arrived; m_tail->next; m_tail = m_tail->next)
+        {
+        }
+      }
+      while (m_head && m_owed.load(std::memory_order_acquire) != 0)
+      {
+        m_owed.fetch_sub(1, std::memory_order_relaxed);
+        details::waiter* next = std::exchange(m_head, m_head->next);
+        if (!m_head)
+        {
+          m_tail = nullptr;
+        }
+        *woken_tail = next;
+        woken_tail = &next->next;
+      }
+      *woken_tail = nullptr;
+      requests = m_drainers.fetch_sub(requests, std::memory_order_acq_rel) - requests;
+    } while (requests != 0);
+    // woken only once no longer draining, a coroutine resumed inline may acquire and release again
+    details::wake_all(woken);
+  }
+
+public:
+  explicit async_semaphore(std::ptrdiff_t permits)
+    : m_count{ permits }
+  {
+  }
+
+  async_semaphore(async_semaphore const&) = delete;
+  void operator=(async_semaphore const&) = delete;
+
+  // a hint only, others may acquire and release concurrently
+  std::ptrdiff_t available() const
+  {
+    std::ptrdiff_t count = m_count.load(std::memory_order_relaxed);
+    return count > 0 ? count : 0;
+  }
+
+  bool try_acquire()
+  {
+    std::ptrdiff_t count = m_count.load(std::memory_order_relaxed);
+    while (count > 0)
+    {
+      if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void release(std::ptrdiff_t permits = 1)
+  {
+    std::ptrdiff_t previous = m_count.fetch_add(permits, std::memory_order_release);
+    std::ptrdiff_t waiting = previous < 0 ? -previous : 0;
+    if (waiting != 0)
+    {
+      m_owed.fetch_add(static_cast<std::size_t>(waiting < permits ? waiting : permits), std::memory_order_release);
+      drain();
+    }
+  }
+
+  // `co_await` returns once the awaiting coroutine holds a permit
+  class acquire_awaiter
+  {
+    async_semaphore* m_semaphore;
+    details::waiter m_node{};
+
+  public:
+    explicit acquire_awaiter(async_semaphore& semaphore)
+      : m_semaphore{ &semaphore }
+    {
+    }
+
+    acquire_awaiter(acquire_awaiter const&) = delete;
+    void operator=(acquire_awaiter const&) = delete;
+
+    bool await_ready() { return m_semaphore->try_acquire(); }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+      auto* semaphore = m_semaphore;
+      if (semaphore->m_count.fetch_sub(1, std::memory_order_acquire) > 0)
+      {
+        return false;
+      }
+      m_node.wake = waker::of(handle);
+      auto& incoming = semaphore->m_incoming;
+      m_node.next = incoming.load(std::memory_order_relaxed);
+      while (!incoming.compare_exchange_weak(m_node.next, &m_node, std::memory_order_release, std::memory_order_relaxed))
+      {
+      }
+      // a release may have counted this waiter before it was pushed, it is the waiter's turn to drain then
+      // once pushed the awaiter may be resumed at any time, `this` is not touched anymore
+      semaphore->drain();
+      return true;
+    }
+
+    void await_resume() {}
+  };
+
+  acquire_awaiter acquire() { return acquire_awaiter{ *this }; }
+};
+
+// a single use countdown, `wait` suspends the awaiting coroutine until the count reached zero
+// waiters sit on a lock-free stack, the last `count_down` swaps it for a sentinel and wakes every one of them
+class async_latch
+{
+  std::atomic<std::ptrdiff_t> m_count;
+  std::atomic<details::waiter*> m_waiters{ nullptr };
+  details::waiter m_released{}; // the sentinel, no waiter may be pushed once it is in place
+
+public:
+  explicit async_latch(std::ptrdiff_t expected)
+    : m_count{ expected }
+  {
+    if (expected <= 0)
+    {
+      m_waiters.store(&m_released, std::memory_order_relaxed);
+    }
+  }
+
+  async_latch(async_latch const&) = delete;
+  void operator=(async_latch const&) = delete;
+
+  // only the call that takes the count from above zero to zero or below releases the waiters, counting down by zero or on a
+  // latch already released does nothing
+  void count_down(std::ptrdiff_t update = 1)
+  {
+    if (update == 0)
+    {
+      return;
+    }
+    auto const previous = m_count.fetch_sub(update, std::memory_order_acq_rel);
+    if (previous > 0 && previous <= update)
+    {
+      auto* waiters = m_waiters.exchange(&m_released, std::memory_order_acq_rel);
+      // the sentinel is installed once, it has no waker of its own and is never woken
+      details::wake_all(waiters != &m_released ? waiters : nullptr);
+    }
+  }
+
+  bool try_wait() const { return m_count.load(std::memory_order_acquire) <= 0; }
+
+  class wait_awaiter
+  {
+    async_latch* m_latch;
+    details::waiter m_node{};
+
+  public:
+    explicit wait_awaiter(async_latch& latch)
+      : m_latch{ &latch }
+    {
+    }
+
+    wait_awaiter(wait_awaiter const&) = delete;
+    void operator=(wait_awaiter const&) = delete;
+
+    bool await_ready() { return m_latch->try_wait(); }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+      m_node.wake = waker::of(handle);
+      auto& waiters = m_latch->m_waiters;
+      m_node.next = waiters.load(std::memory_order_acquire);
+      while (m_node.next != &m_latch->m_released)
+      {
+        if (waiters.compare_exchange_weak(m_node.next, &m_node, std::memory_order_release, std::memory_order_acquire))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void await_resume() {}
+  };
+
+  wait_awaiter wait() { return wait_awaiter{ *this }; }
+
+  // counts down and waits for the others
+  wait_awaiter arrive_and_wait(std::ptrdiff_t update = 1)
+  {
+    count_down(update);
+    return wait_awaiter{ *this };
+  }
+};
+
+// a reusable barrier for a fixed number of participants, each phase completes once all of them called `arrive_and_wait`
+// arrivals push themselves on a lock-free stack before counting down, the last one takes the stack, resets the count for the
+// next phase and wakes the others, it carries on without suspending
+class async_barrier
+{
+  std::ptrdiff_t m_expected;
+  std::atomic<std::ptrdiff_t> m_remaining;
+  std::atomic<details::waiter*> m_waiters{ nullptr };
+
+public:
+  explicit async_barrier(std::ptrdiff_t expected)
+    : m_expected{ expected }
+    , m_remaining{ expected }
+  {
+    details::expects([&] { return expected > 0; }, "[Error]@[Barrier]: a barrier needs at least one participant");
+  }
+
+  async_barrier(async_barrier const&) = delete;
+  void operator=(async_barrier const&) = delete;
+
+  // `co_await` yields true in exactly one participant per phase, the one that completed it
+  class arrive_awaiter
+  {
+    async_barrier* m_barrier;
+    details::waiter m_node{};
+    bool m_last{ false };
+
+  public:
+    explicit arrive_awaiter(async_barrier& barrier)
+      : m_barrier{ &barrier }
+    {
+    }
+
+    arrive_awaiter(arrive_awaiter const&) = delete;
+    void operator=(arrive_awaiter const&) = delete;
+
+    bool await_ready() { return false; }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+      m_node.wake = waker::of(handle);
+      auto* barrier = m_barrier;
+      auto& waiters = barrier->m_waiters;
+      m_node.next = waiters.load(std::memory_order_relaxed);
+      while (!waiters.compare_exchange_weak(m_node.next, &m_node, std::memory_order_release, std::memory_order_relaxed))
+      {
+      }
+      // once counted this awaiter may be resumed at any time, unless it was the last one
+      if (barrier->m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      {
+        return true;
+      }
+      details::waiter* arrived = waiters.exchange(nullptr, std::memory_order_acquire);
+      barrier->m_remaining.store(barrier->m_expected, std::memory_order_release);
+      m_last = true;
+      while (arrived)
+      {
+        details::waiter* node = std::exchange(arrived, arrived->next);
+        if (node != &m_node)
+        {
+          node->wake();
+        }
+      }
+      return false;
+    }
+
+    bool await_resume() { return m_last; }
+  };
+
+  arrive_awaiter arrive_and_wait() { return arrive_awaiter{ *this }; }
+};
+
+} // end namespace tmf
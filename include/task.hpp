@@ -0,0 +1,112 @@
+#pragma once
+
+#include <basic_coroutine.hpp>
+
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace tmf
+{
+
+namespace details
+{
+
+// what a `task<void>` holds once it returned
+struct task_returned
+{
+};
+
+}
+
+// a lazy coroutine producing one `T`, meant to be awaited by another coroutine
+// `co_await child` starts the child on the awaiting thread and registers the awaiting coroutine as its continuation, it is
+// resumed exactly once, by symmetric transfer from the child's final suspension point, nothing polls
+// the result lives in the task object itself, so nothing is allocated beyond the frame
+// a task may not `co_yield`, it runs until it returns, suspending only to await
+template<typename T = void>
+class task : public basic_coroutine<task<T>>
+{
+  using stored_type = std::conditional_t<std::is_void_v<T>, details::task_returned, T>;
+
+  std::variant<std::monostate, stored_type, std::exception_ptr> m_result{};
+
+public:
+  task() = default;
+  task(task&&) = default;
+  task& operator=(task&&) = default;
+
+  ///! <customization points>
+
+  auto on_invoke()
+  {
+    return co_control::suspend;
+  }
+
+  void on_return() requires std::is_void_v<T>
+  {
+    m_result.template emplace<1>();
+  }
+
+  template<typename U>
+  requires (!std::is_void_v<T>) && std::constructible_from<stored_type, U&&>
+  void on_return(U&& value)
+  {
+    m_result.template emplace<1>(std::forward<U>(value));
+  }
+
+  void on_error(std::exception_ptr e)
+  {
+    m_result.template emplace<2>(e);
+  }
+
+  ///! </customization points>
+
+  // the returned value, moved out, or the exception the task ended with, rethrown
+  T result()
+  {
+    if (auto* e = std::get_if<2>(&m_result))
+    {
+      std::rethrow_exception(*e);
+    }
+    details::expects(
+      [&] { return m_result.index() != 0; },
+      "[Error]@[Task]: the task has not returned yet, it is either running or was never started"
+    );
+    if constexpr (!std::is_void_v<T>)
+    {
+      return std::move(std::get<1>(m_result));
+    }
+  }
+
+  class awaiter
+  {
+    task* m_task;
+    parked_coroutine m_awaiting{};
+
+  public:
+    explicit awaiter(task& awaited)
+      : m_task{ &awaited }
+    {
+    }
+
+    bool await_ready() { return m_task->done(); }
+
+    // a task that cannot be started hands control straight back, `result` then reports why
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting)
+    {
+      m_awaiting.park(awaiting);
+      return m_task->resume_with(m_awaiting.then());
+    }
+
+    T await_resume() { return m_task->result(); }
+  };
+
+  awaiter operator co_await() { return awaiter{ *this }; }
+};
+
+} // end namespace tmf
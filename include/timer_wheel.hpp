@@ -0,0 +1,372 @@
+#pragma once
+
+#include <contract.hpp>
+#include <continuation.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace tmf
+{
+
+struct timer_links
+{
+  timer_links* prev{ nullptr };
+  timer_links* next{ nullptr };
+};
+
+// an intrusive timer, linked into one slot of a `timer_wheel` while pending
+// whoever owns it keeps it alive until it fired or was cancelled
+struct timer : timer_links
+{
+  void (*fire)(timer*){ nullptr };
+  std::uint64_t expiry{ 0 }; // in ticks of the wheel it is scheduled on
+  std::uint16_t slot{ 0 };
+
+  bool pending() const { return next != nullptr; }
+};
+
+// a hierarchical timing wheel (Varghese & Lauck), 4 levels of 256 slots each
+// a timer is linked into the slot its expiry falls in at the coarsest level needed, and moves down one level each time the
+// level below it completes a rotation, so scheduling and cancelling are O(1) and each timer is touched at most 4 times
+// time is counted in ticks of `resolution` since construction, timers fire at the first `advance` past their deadline
+// a wheel is driven by one thread, timers must be scheduled and cancelled from that thread
+class timer_wheel
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+private:
+  static constexpr unsigned slot_bits = 8;
+  static constexpr unsigned slots = 1u << slot_bits;
+  static constexpr unsigned levels = 4;
+  static constexpr std::uint64_t horizon = std::uint64_t{ 1 } << (slot_bits * levels); // ticks covered by the wheel
+
+  timer_links m_slots[levels][slots];
+  std::uint64_t m_occupied[levels][slots / 64]{};
+  clock::time_point m_origin;
+  clock::duration m_resolution;
+  std::uint64_t m_now{ 0 };
+  std::size_t m_size{ 0 };
+
+  static timer_wheel*& current_slot()
+  {
+    static thread_local timer_wheel* value{ nullptr };
+    return value;
+  }
+
+  static void push(timer_links& head, timer_links& node)
+  {
+    node.prev = head.prev;
+    node.next = &head;
+    head.prev->next = &node;
+    head.prev = &node;
+  }
+
+  static void unlink(timer_links& node)
+  {
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+    node.prev = node.next = nullptr;
+  }
+
+  // links `t` where its expiry falls relative to the current tick, timers past the horizon are re-placed when cascaded
+  void place(timer& t)
+  {
+    std::uint64_t const delta = std::min(t.expiry - std::min(t.expiry, m_now), horizon - 1);
+    std::uint64_t const expiry = m_now + delta;
+    unsigned const level = delta < slots ? 0 : (std::bit_width(delta) - 1) / slot_bits;
+    unsigned const index = static_cast<unsigned>(expiry >> (level * slot_bits)) & (slots - 1);
+    t.slot = static_cast<std::uint16_t>(level * slots + index);
+    push(m_slots[level][index], t);
+    m_occupied[level][index / 64] |= std::uint64_t{ 1 } << (index % 64);
+  }
+
+  void mark_if_empty(unsigned level, unsigned index)
+  {
+    timer_links& head = m_slots[level][index];
+    if (head.next == &head)
+    {
+      m_occupied[level][index / 64] &= ~(std::uint64_t{ 1 } << (index % 64));
+    }
+  }
+
+  // moves the content of a slot onto a local list, so that fired timers may schedule and cancel freely
+  void detach(unsigned level, unsigned index, timer_links& list)
+  {
+    timer_links& head = m_slots[level][index];
+    list.prev = list.next = &list;
+    if (head.next != &head)
+    {
+      list.next = head.next;
+      list.prev = head.prev;
+      list.next->prev = &list;
+      list.prev->next = &list;
+      head.prev = head.next = &head;
+    }
+    m_occupied[level][index / 64] &= ~(std::uint64_t{ 1 } << (index % 64));
+  }
+
+  void cascade(unsigned level)
+  {
+    timer_links list;
+    detach(level, static_cast<unsigned>(m_now >> (level * slot_bits)) & (slots - 1), list);
+    while (list.next != &list)
+    {
+      timer& t = static_cast<timer&>(*list.next);
+      unlink(t);
+      place(t);
+    }
+  }
+
+  std::size_t fire_current()
+  {
+    timer_links list;
+    detach(0, static_cast<unsigned>(m_now) & (slots - 1), list);
+    std::size_t fired = 0;
+    while (list.next != &list)
+    {
+      timer& t = static_cast<timer&>(*list.next);
+      unlink(t);
+      if (t.expiry > m_now)
+      {
+        place(t);
+        continue;
+      }
+      --m_size;
+      ++fired;
+      t.fire(&t);
+    }
+    return fired;
+  }
+
+  // the first occupied level 0 slot in (m_now, limit], or `limit`, `limit` may not cross the next rotation
+  std::uint64_t next_occupied(std::uint64_t limit) const
+  {
+    std::uint64_t const base = m_now & ~std::uint64_t{ slots - 1 };
+    unsigned index = static_cast<unsigned>(m_now - base) + 1;
+    unsigned const end = static_cast<unsigned>(std::min<std::uint64_t>(limit - base, slots));
+    while (index < end)
+    {
+      std::uint64_t word = m_occupied[0][index / 64] >> (index % 64);
+      if (word)
+      {
+        index += static_cast<unsigned>(std::countr_zero(word));
+        return index < end ? base + index : limit;
+      }
+      index = (index / 64 + 1) * 64;
+    }
+    return limit;
+  }
+
+  std::uint64_t to_tick(clock::time_point t) const
+  {
+    if (t <= m_origin)
+    {
+      return 0;
+    }
+    return static_cast<std::uint64_t>((t - m_origin + m_resolution - clock::duration{ 1 }) / m_resolution);
+  }
+
+public:
+  explicit timer_wheel(clock::duration resolution = std::chrono::milliseconds{ 1 })
+    : m_origin{ clock::now() }
+    , m_resolution{ resolution }
+  {
+    for (auto& level : m_slots)
+    {
+      for (auto& head : level)
+      {
+        head.prev = head.next = &head;
+      }
+    }
+    if (!current_slot())
+    {
+      current_slot() = this;
+    }
+  }
+
+  timer_wheel(timer_wheel const&) = delete;
+  void operator=(timer_wheel const&) = delete;
+
+  // pending timers never fire
+  ~timer_wheel()
+  {
+    if (current_slot() == this)
+    {
+      current_slot() = nullptr;
+    }
+  }
+
+  // the first wheel created on the calling thread, used by the awaitables that do not name one
+  static timer_wheel* current() { return current_slot(); }
+
+  clock::duration resolution() const { return m_resolution; }
+
+  // how many timers are pending
+  std::size_t size() const { return m_size; }
+
+  // `t.fire(&t)` is called by the first `advance` reaching `deadline`, a deadline in the past fires on the next `advance`
+  void schedule(timer& t, clock::time_point deadline)
+  {
+    if (t.pending())
+    {
+      cancel(t);
+    }
+    t.expiry = std::max(to_tick(deadline), m_now + 1);
+    place(t);
+    ++m_size;
+  }
+
+  // unlinks a pending timer, it will not fire
+  void cancel(timer& t)
+  {
+    if (!t.pending())
+    {
+      return;
+    }
+    unlink(t);
+    mark_if_empty(t.slot / slots, t.slot % slots);
+    --m_size;
+  }
+
+  // fires every timer due by `now`, returns how many fired
+  std::size_t advance(clock::time_point now = clock::now())
+  {
+    std::uint64_t const target = std::max(now - m_origin, clock::duration{ 0 }) / m_resolution;
+    std::size_t fired = 0;
+    while (m_now < target)
+    {
+      if (m_size == 0)
+      {
+        m_now = target;
+        break;
+      }
+      // empty ticks are skipped up to the next rotation, where the coarser levels need cascading
+      std::uint64_t const rotation = (m_now | (slots - 1)) + 1;
+      m_now = next_occupied(std::min(target, rotation));
+      if (m_now == rotation)
+      {
+        for (unsigned level = levels - 1; level > 0; --level)
+        {
+          if ((m_now & ((std::uint64_t{ 1 } << (level * slot_bits)) - 1)) == 0)
+          {
+            cascade(level);
+          }
+        }
+      }
+      fired += fire_current();
+    }
+    return fired;
+  }
+
+  // when `advance` should be called next, either a timer expires or coarser timers need to move down a level
+  // `clock::time_point::max()` when no timer is pending
+  clock::time_point next_deadline() const
+  {
+    if (m_size == 0)
+    {
+      return clock::time_point::max();
+    }
+    std::uint64_t const rotation = (m_now | (slots - 1)) + 1;
+    return m_origin + m_resolution * next_occupied(rotation);
+  }
+
+  // milliseconds until `next_deadline`, rounded up, or -1 when no timer is pending, ready to pass to `reactor::poll`
+  std::chrono::milliseconds timeout() const
+  {
+    if (m_size == 0)
+    {
+      return std::chrono::milliseconds{ -1 };
+    }
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(next_deadline() - clock::now());
+    return std::max(remaining, std::chrono::milliseconds{ 0 });
+  }
+
+  // sleeps the calling thread between deadlines until no timer is left
+  void run()
+  {
+    while (m_size)
+    {
+      std::this_thread::sleep_until(next_deadline());
+      advance();
+    }
+  }
+};
+
+// suspends the awaiting coroutine until a deadline, the coroutine is resumed from `timer_wheel::advance`
+// destroying a suspended sleep cancels its timer
+class sleep_awaiter : timer
+{
+  timer_wheel* m_wheel;
+  timer_wheel::clock::time_point m_deadline;
+  parked_coroutine m_waiter{};
+
+public:
+  sleep_awaiter(timer_wheel& wheel, timer_wheel::clock::time_point deadline)
+    : m_wheel{ &wheel }
+    , m_deadline{ deadline }
+  {
+    fire = [](timer* self) { static_cast<sleep_awaiter*>(self)->m_waiter().resume(); };
+  }
+
+  sleep_awaiter(sleep_awaiter const&) = delete;
+  void operator=(sleep_awaiter const&) = delete;
+
+  ~sleep_awaiter() { m_wheel->cancel(*this); }
+
+  bool await_ready() { return m_deadline <= timer_wheel::clock::now(); }
+
+  template<typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle)
+  {
+    m_waiter.park(handle);
+    m_wheel->schedule(*this, m_deadline);
+  }
+
+  void await_resume() {}
+};
+
+inline sleep_awaiter sleep_until(timer_wheel& wheel, timer_wheel::clock::time_point deadline)
+{
+  return { wheel, deadline };
+}
+
+template<typename Rep, typename Period>
+sleep_awaiter sleep_for(timer_wheel& wheel, std::chrono::duration<Rep, Period> duration)
+{
+  return { wheel, timer_wheel::clock::now() + std::chrono::ceil<timer_wheel::clock::duration>(duration) };
+}
+
+namespace details
+{
+
+inline timer_wheel& current_wheel()
+{
+  details::expects(
+    [] { return timer_wheel::current() != nullptr; },
+    "[Error]@[Timer Wheel]: no timer wheel was created on this thread, pass one to the sleep"
+  );
+  return *timer_wheel::current();
+}
+
+} // end namespace details
+
+// the same awaitables on `timer_wheel::current()`, which has to exist
+inline sleep_awaiter sleep_until(timer_wheel::clock::time_point deadline)
+{
+  return sleep_until(details::current_wheel(), deadline);
+}
+
+template<typename Rep, typename Period>
+sleep_awaiter sleep_for(std::chrono::duration<Rep, Period> duration)
+{
+  return sleep_for(details::current_wheel(), duration);
+}
+
+} // end namespace tmf
@@ -0,0 +1,273 @@
+#pragma once
+
+// lifecycle tracing of every `basic_promise`, compiled in only when `BASIC_COROUTINE_TRACING` is defined
+// `basic_promise` records through `BASIC_COROUTINE_TRACE`, which expands to nothing otherwise, so a build without the macro
+// carries no trace of tracing at all
+
+#ifdef BASIC_COROUTINE_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace tmf::trace
+{
+
+enum class event : std::uint8_t
+{
+  invoke,  // the coroutine was created, at its initial suspension point
+  resume,  // a thread started running it
+  yield,   // `co_yield`
+  await,   // `co_await`
+  suspend, // the running thread let go of it
+  finish,  // it returned or threw, at its final suspension point
+};
+
+inline char const* name_of(event e)
+{
+  switch (e)
+  {
+    case event::invoke: return "invoke";
+    case event::resume: return "resume";
+    case event::yield: return "yield";
+    case event::await: return "await";
+    case event::suspend: return "suspend";
+    case event::finish: return "finish";
+  }
+  return "unknown";
+}
+
+// the time stamp counter where there is one, steady clock nanoseconds elsewhere
+inline std::uint64_t timestamp()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+namespace details
+{
+
+// a ring of the most recent events of one thread, only that thread writes to it
+// the fields are relaxed atomics so that an export may read a ring while its thread keeps recording, it skips whatever may
+// have been overwritten meanwhile
+class ring
+{
+public:
+  static constexpr std::size_t capacity = std::size_t{ 1 } << 16;
+
+private:
+  struct slot
+  {
+    std::atomic<std::uint64_t> ticks;
+    std::atomic<std::uintptr_t> frame;
+    std::atomic<std::uint8_t> kind;
+  };
+
+  std::unique_ptr<slot[]> m_slots{ new slot[capacity] };
+  std::atomic<std::uint64_t> m_written{ 0 };
+
+public:
+  ring* next{ nullptr };
+  ring* next_free{ nullptr };
+  std::uint32_t const thread;
+
+  explicit ring(std::uint32_t thread_index)
+    : thread{ thread_index }
+  {
+  }
+
+  void record(event kind, void const* frame)
+  {
+    std::uint64_t const index = m_written.load(std::memory_order_relaxed);
+    slot& s = m_slots[index & (capacity - 1)];
+    s.ticks.store(timestamp(), std::memory_order_relaxed);
+    s.frame.store(reinterpret_cast<std::uintptr_t>(frame), std::memory_order_relaxed);
+    s.kind.store(static_cast<std::uint8_t>(kind), std::memory_order_relaxed);
+    m_written.store(index + 1, std::memory_order_release);
+  }
+
+  // calls `f(ticks, frame, kind)` for every event still in the ring, oldest first
+  template<typename F>
+  void for_each(F&& f) const
+  {
+    std::uint64_t const end = m_written.load(std::memory_order_acquire);
+    std::uint64_t begin = end > capacity ? end - capacity : 0;
+    for (std::uint64_t index = begin; index < end; ++index)
+    {
+      slot const& s = m_slots[index & (capacity - 1)];
+      std::uint64_t const ticks = s.ticks.load(std::memory_order_relaxed);
+      std::uintptr_t const frame = s.frame.load(std::memory_order_relaxed);
+      auto const kind = static_cast<event>(s.kind.load(std::memory_order_relaxed));
+      // the writer may have lapped the reader, such a slot belongs to a newer event
+      std::atomic_thread_fence(std::memory_order_acquire);
+      std::uint64_t const written = m_written.load(std::memory_order_relaxed);
+      if (written > capacity && index < written - capacity)
+      {
+        continue;
+      }
+      f(ticks, frame, kind);
+    }
+  }
+};
+
+// every ring ever created, pushed lock-free by the thread that records first
+// rings are never freed, threads outliving `main` may still be recording while static objects are destroyed, but a thread
+// hands its ring back when it exits and the next thread to record takes it over, so there are only as many rings as threads
+// ever recorded at once, a reused ring keeps its track and the events of its previous threads until they are overwritten
+struct registry
+{
+  std::atomic<ring*> head{ nullptr };
+  std::atomic<std::uint32_t> threads{ 0 };
+  std::mutex free_lock;
+  ring* free{ nullptr };
+  std::uint64_t origin_ticks{ timestamp() };
+  std::chrono::steady_clock::time_point origin_time{ std::chrono::steady_clock::now() };
+
+  static registry& instance()
+  {
+    static registry* value = new registry{};
+    return *value;
+  }
+
+  ring& join()
+  {
+    {
+      std::lock_guard guard{ free_lock };
+      if (free)
+      {
+        return *std::exchange(free, free->next_free);
+      }
+    }
+    auto* created = new ring{ threads.fetch_add(1, std::memory_order_relaxed) };
+    created->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(created->next, created, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    return *created;
+  }
+
+  void leave(ring& left)
+  {
+    std::lock_guard guard{ free_lock };
+    left.next_free = std::exchange(free, &left);
+  }
+
+  // time stamp counter ticks per microsecond, measured against the steady clock since the first event
+  double ticks_per_microsecond() const
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    using namespace std::chrono;
+    // a short baseline gives a poor estimate, wait until it spans at least 10ms
+    while (steady_clock::now() - origin_time < milliseconds{ 10 })
+    {
+      std::this_thread::yield();
+    }
+    std::uint64_t const ticks = timestamp();
+    auto const elapsed = duration<double, std::micro>(steady_clock::now() - origin_time).count();
+    return static_cast<double>(ticks - origin_ticks) / elapsed;
+#else
+    return 1000.0;
+#endif
+  }
+};
+
+inline thread_local ring* current_ring = nullptr;
+
+// hands the ring back when its thread exits, a thread still recording from a later thread local destructor joins again and
+// keeps that ring
+struct ring_lease
+{
+  ~ring_lease()
+  {
+    if (current_ring)
+    {
+      registry::instance().leave(*std::exchange(current_ring, nullptr));
+    }
+  }
+};
+
+inline thread_local ring_lease lease{};
+
+inline ring& local_ring()
+{
+  if (!current_ring)
+  {
+    current_ring = &registry::instance().join();
+    (void)&lease;
+  }
+  return *current_ring;
+}
+
+} // end namespace details
+
+inline void record(event kind, void const* frame)
+{
+  details::local_ring().record(kind, frame);
+}
+
+// how many events each thread keeps, older ones are overwritten
+inline constexpr std::size_t events_per_thread = details::ring::capacity;
+
+// writes every event still held by any thread as Chrome trace event JSON, for chrome://tracing or ui.perfetto.dev
+// a coroutine running on a thread is a slice from `resume` to `suspend` named after its frame, every other event is an instant
+// may be called while coroutines are running, whatever is recorded meanwhile may or may not be included
+inline void write_chrome_json(std::ostream& out)
+{
+  auto& registry = details::registry::instance();
+  double const scale = registry.ticks_per_microsecond();
+  char buffer[256];
+  bool first = true;
+  auto emit = [&](int length) {
+    out << (first ? "\n" : ",\n");
+    out.write(buffer, length);
+    first = false;
+  };
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  for (auto* r = registry.head.load(std::memory_order_acquire); r; r = r->next)
+  {
+    emit(std::snprintf(buffer, sizeof(buffer),
+      R"({"name":"thread_name","ph":"M","pid":1,"tid":%u,"args":{"name":"thread %u"}})", r->thread, r->thread));
+    r->for_each([&](std::uint64_t ticks, std::uintptr_t frame, event kind) {
+      double const ts = static_cast<double>(static_cast<std::int64_t>(ticks - registry.origin_ticks)) / scale;
+      switch (kind)
+      {
+        case event::resume:
+        case event::suspend:
+          emit(std::snprintf(buffer, sizeof(buffer),
+            R"({"name":"coroutine 0x%jx","cat":"coroutine","ph":"%c","ts":%.3f,"pid":1,"tid":%u})",
+            static_cast<std::uintmax_t>(frame), kind == event::resume ? 'B' : 'E', ts, r->thread));
+          break;
+        default:
+          emit(std::snprintf(buffer, sizeof(buffer),
+            R"({"name":"%s","cat":"coroutine","ph":"i","s":"t","ts":%.3f,"pid":1,"tid":%u,"args":{"frame":"0x%jx"}})",
+            name_of(kind), ts, r->thread, static_cast<std::uintmax_t>(frame)));
+          break;
+      }
+    });
+  }
+  out << "\n]}\n";
+}
+
+} // end namespace tmf::trace
+
+#define BASIC_COROUTINE_TRACE(kind, frame) ::tmf::trace::record(::tmf::trace::event::kind, frame)
+
+#else
+
+#define BASIC_COROUTINE_TRACE(kind, frame) ((void)0)
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <coroutine>
+
+namespace tmf
+{
+
+// how a coroutine parked on a synchronization object is woken by whoever releases it
+// a promise with a `wake()` member, as `basic_promise` has, decides for itself, so an executor gets the resume back
+// any other coroutine is resumed right away on the waking thread
+// a function pointer and an address, taking one never allocates
+class waker
+{
+  void (*m_wake)(void*){ nullptr };
+  void* m_address{ nullptr };
+
+  waker(void (*wake)(void*), void* address)
+    : m_wake{ wake }
+    , m_address{ address }
+  {
+  }
+
+public:
+  waker() = default;
+
+  template<typename Promise>
+  static waker of(std::coroutine_handle<Promise> handle)
+  {
+    if constexpr (requires(Promise& p) { p.wake(); })
+    {
+      return { [](void* address) { std::coroutine_handle<Promise>::from_address(address).promise().wake(); }, handle.address() };
+    }
+    else
+    {
+      return { [](void* address) { std::coroutine_handle<>::from_address(address).resume(); }, handle.address() };
+    }
+  }
+
+  explicit operator bool() const { return m_wake != nullptr; }
+
+  void operator()() const { m_wake(m_address); }
+};
+
+} // end namespace tmf
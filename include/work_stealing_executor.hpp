@@ -0,0 +1,463 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <schedule_node.hpp>
+
+namespace tmf
+{
+
+inline namespace details
+{
+
+// a move-only type-erased `void()` callable
+// the resume callables handed out by `basic_promise` capture a single handle or pointer and are stored inline
+class job
+{
+  static constexpr std::size_t inline_size = 3 * sizeof(void*);
+
+  struct operations
+  {
+    void (*invoke)(void*);
+    void (*relocate)(void* from, void* to) noexcept;
+    void (*destroy)(void*) noexcept;
+  };
+
+  template<typename F>
+  static constexpr bool stored_inline =
+    sizeof(F) <= inline_size && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+  template<typename F>
+  static constexpr operations inline_operations{
+    [](void* storage) { (*static_cast<F*>(storage))(); },
+    [](void* from, void* to) noexcept
+    {
+      ::new (to) F(std::move(*static_cast<F*>(from)));
+      static_cast<F*>(from)->~F();
+    },
+    [](void* storage) noexcept { static_cast<F*>(storage)->~F(); }
+  };
+
+  template<typename F>
+  static constexpr operations heap_operations{
+    [](void* storage) { (**static_cast<F**>(storage))(); },
+    [](void* from, void* to) noexcept { ::new (to) F*(*static_cast<F**>(from)); },
+    [](void* storage) noexcept { delete *static_cast<F**>(storage); }
+  };
+
+  alignas(std::max_align_t) std::byte m_storage[inline_size];
+  operations const* m_operations{ nullptr };
+
+public:
+  job() = default;
+
+  template<typename F>
+  requires (!std::is_same_v<std::remove_cvref_t<F>, job>)
+  job(F&& callable)
+  {
+    using Callable = std::decay_t<F>;
+    if constexpr (stored_inline<Callable>)
+    {
+      ::new (static_cast<void*>(m_storage)) Callable(std::forward<F>(callable));
+      m_operations = &inline_operations<Callable>;
+    }
+    else
+    {
+      ::new (static_cast<void*>(m_storage)) Callable*(new Callable(std::forward<F>(callable)));
+      m_operations = &heap_operations<Callable>;
+    }
+  }
+
+  job(job&& other) noexcept
+    : m_operations{ std::exchange(other.m_operations, nullptr) }
+  {
+    if (m_operations)
+    {
+      m_operations->relocate(other.m_storage, m_storage);
+    }
+  }
+
+  job& operator=(job&& other) noexcept
+  {
+    if (this != &other)
+    {
+      reset();
+      m_operations = std::exchange(other.m_operations, nullptr);
+      if (m_operations)
+      {
+        m_operations->relocate(other.m_storage, m_storage);
+      }
+    }
+    return *this;
+  }
+
+  ~job() { reset(); }
+
+  void reset() noexcept
+  {
+    if (m_operations)
+    {
+      std::exchange(m_operations, nullptr)->destroy(m_storage);
+    }
+  }
+
+  explicit operator bool() const { return m_operations != nullptr; }
+
+  // runs the callable once and leaves the job empty
+  void operator()()
+  {
+    job running{ std::move(*this) };
+    running.m_operations->invoke(running.m_storage);
+  }
+};
+
+} // end namespace details
+
+// a fixed set of worker threads sharing work by stealing
+// - each worker owns a deque, schedules made from a worker thread stay on that worker
+// - the most recent schedule of a worker goes to its LIFO slot and runs next, while its caches are still warm, if the worker
+//   stays in the job that filled the slot, other workers take it after a bounded number of fruitless searches
+// - idle workers steal half of a random victim's deque, and park when there is nothing left anywhere
+// - schedules from outside the pool go through a shared injection queue
+// plugs into the executor customization point, with callables or with the promise's node:
+//   template<typename F> void executor(F&& f) { pool.execute(std::forward<F>(f)); }
+//   void executor(tmf::schedule_node& node) { pool.execute(node); }
+class work_stealing_executor
+{
+  struct alignas(64) worker
+  {
+    std::mutex mutex;
+    std::deque<details::job> queue;
+    details::job lifo_slot; // filled by the owner while `lifo` is empty, moved out by whoever claims it
+    std::atomic<std::uint32_t> lifo{ lifo_empty };
+    std::atomic<std::uint32_t> started{ 0 }; // jobs the owner began, only written by the owner
+    std::uint64_t rng;
+    std::thread thread;
+  };
+
+  struct current_worker
+  {
+    work_stealing_executor* pool{ nullptr };
+    worker* self{ nullptr };
+  };
+
+  static current_worker& current()
+  {
+    static thread_local current_worker value{};
+    return value;
+  }
+
+  std::vector<std::unique_ptr<worker>> m_workers;
+
+  std::mutex m_injector_mutex;
+  std::deque<details::job> m_injector;
+
+  std::atomic<std::uint32_t> m_epoch{ 0 }; // bumped on every schedule, parked workers wait on it
+  std::atomic<std::size_t> m_idle{ 0 };
+  std::atomic<std::size_t> m_pending{ 0 }; // jobs sitting in deques or the injector, LIFO slots count themselves
+  std::atomic<bool> m_stopping{ false };
+
+  // the state of a LIFO slot, a full slot keeps the owner's `started` count from when it was filled in the upper bits, so a
+  // thief can tell whether the owner is still in that same job
+  static constexpr std::uint32_t lifo_empty = 0;
+  static constexpr std::uint32_t lifo_moving = 1; // claimed by a thief, which is moving the job out
+  static constexpr std::uint32_t lifo_full = 2;
+
+  // fruitless searches in a row, while jobs were waiting, before a thief takes the LIFO slot of a worker that is still busy
+  static constexpr std::size_t lifo_patience = 16;
+
+  static std::uint32_t lifo_filled_at(std::uint32_t started) { return (started << 2) | lifo_full; }
+
+  void notify()
+  {
+    m_epoch.fetch_add(1);
+    if (m_idle.load() > 0)
+    {
+      m_epoch.notify_one();
+    }
+  }
+
+  static std::uint64_t next_random(std::uint64_t& state)
+  {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  }
+
+  // claims a full LIFO slot, with `stale_only` only when its owner has not started another job since filling it
+  static details::job take_lifo(worker& owner, bool stale_only)
+  {
+    std::uint32_t state = owner.lifo.load(std::memory_order_acquire);
+    if (!(state & lifo_full))
+    {
+      return {};
+    }
+    if (stale_only && state != lifo_filled_at(owner.started.load(std::memory_order_relaxed)))
+    {
+      return {};
+    }
+    if (!owner.lifo.compare_exchange_strong(state, lifo_moving, std::memory_order_acquire))
+    {
+      return {};
+    }
+    details::job result{ std::move(owner.lifo_slot) };
+    owner.lifo.store(lifo_empty, std::memory_order_release);
+    return result;
+  }
+
+  // is a job waiting anywhere, including LIFO slots
+  bool work_left() const
+  {
+    if (m_pending.load() > 0)
+    {
+      return true;
+    }
+    return std::ranges::any_of(m_workers, [](auto const& w) { return (w->lifo.load() & lifo_full) != 0; });
+  }
+
+  details::job pop_local(worker& self)
+  {
+    if (auto found = take_lifo(self, false))
+    {
+      return found;
+    }
+    std::scoped_lock lock{ self.mutex };
+    if (self.queue.empty())
+    {
+      return {};
+    }
+    auto result = std::move(self.queue.front());
+    self.queue.pop_front();
+    m_pending.fetch_sub(1);
+    return result;
+  }
+
+  details::job pop_injected()
+  {
+    std::scoped_lock lock{ m_injector_mutex };
+    if (m_injector.empty())
+    {
+      return {};
+    }
+    auto result = std::move(m_injector.front());
+    m_injector.pop_front();
+    m_pending.fetch_sub(1);
+    return result;
+  }
+
+  // moves up to half of a victim's deque over to `self`, returns one of the stolen jobs to run
+  // the victim lock is released before taking our own, so two thieves can never wait on each other
+  // once `impatient` it also takes the LIFO slot of a victim that has not started another job since it filled the slot
+  details::job steal(worker& self, bool impatient)
+  {
+    static constexpr std::size_t max_batch = 32;
+    std::size_t const count = m_workers.size();
+    std::size_t const start = next_random(self.rng) % count;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      worker& victim = *m_workers[(start + i) % count];
+      if (&victim == &self)
+      {
+        continue;
+      }
+      if (impatient)
+      {
+        if (auto found = take_lifo(victim, true))
+        {
+          return found;
+        }
+      }
+      details::job batch[max_batch];
+      std::size_t stolen = 0;
+      {
+        std::unique_lock victim_lock{ victim.mutex, std::try_to_lock };
+        if (!victim_lock || victim.queue.empty())
+        {
+          continue;
+        }
+        std::size_t const half = std::min((victim.queue.size() + 1) / 2, max_batch);
+        for (; stolen < half; ++stolen)
+        {
+          batch[stolen] = std::move(victim.queue.back());
+          victim.queue.pop_back();
+        }
+      }
+      if (stolen > 1)
+      {
+        std::scoped_lock self_lock{ self.mutex };
+        for (std::size_t n = 1; n < stolen; ++n)
+        {
+          self.queue.push_front(std::move(batch[n]));
+        }
+      }
+      m_pending.fetch_sub(1);
+      return std::move(batch[0]);
+    }
+    return {};
+  }
+
+  details::job find_work(worker& self, bool impatient)
+  {
+    if (auto found = pop_local(self))
+    {
+      return found;
+    }
+    if (auto found = pop_injected())
+    {
+      return found;
+    }
+    if (impatient || m_pending.load() > 0)
+    {
+      return steal(self, impatient);
+    }
+    return {};
+  }
+
+  void run(worker& self)
+  {
+    current() = { this, &self };
+    std::size_t fruitless = 0;
+    while (true)
+    {
+      if (auto found = find_work(self, fruitless >= lifo_patience))
+      {
+        fruitless = 0;
+        self.started.store(self.started.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        found();
+        continue;
+      }
+      // park, the epoch is read before looking for work so no schedule in between can be missed
+      m_idle.fetch_add(1);
+      auto const epoch = m_epoch.load();
+      if (work_left())
+      {
+        // what is left may sit in the LIFO slot of a busy or blocked worker, it is searched for again until it can be taken
+        m_idle.fetch_sub(1);
+        ++fruitless;
+        std::this_thread::yield();
+        continue;
+      }
+      if (m_stopping.load())
+      {
+        m_idle.fetch_sub(1);
+        break;
+      }
+      m_epoch.wait(epoch);
+      m_idle.fetch_sub(1);
+    }
+    current() = {};
+  }
+
+public:
+  explicit work_stealing_executor(std::size_t worker_count = std::thread::hardware_concurrency())
+  {
+    if (worker_count == 0)
+    {
+      worker_count = 1;
+    }
+    m_workers.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i)
+    {
+      m_workers.push_back(std::make_unique<worker>());
+      m_workers.back()->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+    }
+    for (auto& w : m_workers)
+    {
+      w->thread = std::thread{ [this, self = w.get()]() { run(*self); } };
+    }
+  }
+
+  work_stealing_executor(work_stealing_executor const&) = delete;
+  void operator=(work_stealing_executor const&) = delete;
+
+  // runs what is already scheduled, then joins the workers
+  ~work_stealing_executor()
+  {
+    m_stopping.store(true);
+    m_epoch.fetch_add(1);
+    m_epoch.notify_all();
+    for (auto& w : m_workers)
+    {
+      w->thread.join();
+    }
+  }
+
+  std::size_t size() const { return m_workers.size(); }
+
+  // how many jobs wait in the LIFO slots, the deques and the injection queue, a gauge for monitoring, not exact while workers run
+  std::size_t pending() const
+  {
+    auto const slots = std::ranges::count_if(m_workers, [](auto const& w) {
+      return (w->lifo.load(std::memory_order_relaxed) & lifo_full) != 0;
+    });
+    return m_pending.load(std::memory_order_relaxed) + static_cast<std::size_t>(slots);
+  }
+
+  // is the calling thread one of this executor's workers?
+  bool running_in_this_thread() const { return current().pool == this; }
+
+  template<typename F>
+  void execute(F&& callable)
+  {
+    details::job scheduled{ std::forward<F>(callable) };
+    auto [pool, self] = current();
+    // counted before it becomes visible, so a thief never observes a job the counter does not cover
+    if (pool == this)
+    {
+      // the newest job takes the LIFO slot, whatever was there is queued for others to steal
+      // while a thief is moving the previous one out, the new one is queued instead
+      details::job displaced = take_lifo(*self, false);
+      if (self->lifo.load(std::memory_order_acquire) == lifo_empty)
+      {
+        self->lifo_slot = std::move(scheduled);
+        // the exchange orders the slot before reading `m_idle`, a worker about to park either sees the slot or is notified
+        self->lifo.exchange(lifo_filled_at(self->started.load(std::memory_order_relaxed)));
+        scheduled = std::move(displaced);
+        if (!scheduled)
+        {
+          if (m_idle.load() > 0)
+          {
+            notify();
+          }
+          return;
+        }
+      }
+      m_pending.fetch_add(1);
+      std::scoped_lock lock{ self->mutex };
+      self->queue.push_back(std::move(scheduled));
+    }
+    else
+    {
+      m_pending.fetch_add(1);
+      std::scoped_lock lock{ m_injector_mutex };
+      m_injector.push_back(std::move(scheduled));
+    }
+    notify();
+  }
+
+  // queues a promise's intrusive node, the job only holds the node pointer so nothing is allocated
+  void execute(schedule_node& node)
+  {
+    execute([&node]() { node(); });
+  }
+
+  template<typename F>
+  void operator()(F&& callable)
+  {
+    execute(std::forward<F>(callable));
+  }
+};
+
+} // end namespace tmf